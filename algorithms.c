@@ -2,6 +2,8 @@
 #include "config.h"
 #include "utils.h"
 #include "world.h"
+#include "ant_logic.h"
+#include "thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -50,6 +52,128 @@ void sort_ants_by_efficiency(Ant** ants, int count) {
     print_info("Ant sorting complete");
 }
 
+// Radix sort: 8-bit digits. Keys are split into bands that count and then
+// scatter their digits in parallel; a band's elements go to offsets after
+// every earlier band's with the same digit, which keeps the sort stable
+// whatever the band count.
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct {
+    const uint32_t* keys;
+    const uint32_t* values;
+    uint32_t* out_keys;
+    uint32_t* out_values;
+    int count;
+    int shift;
+    int* offsets;  // RADIX_BUCKETS per band: counts, then write positions
+} RadixPass;
+
+static int radix_band_start(const RadixPass* pass, int band, int band_count) {
+    return (int)((int64_t)pass->count * band / band_count);
+}
+
+static void radix_count_band(void* context, int band, int band_count) {
+    RadixPass* pass = (RadixPass*)context;
+    int* counts = pass->offsets + (size_t)band * RADIX_BUCKETS;
+    int end = radix_band_start(pass, band + 1, band_count);
+    
+    memset(counts, 0, RADIX_BUCKETS * sizeof(int));
+    for (int i = radix_band_start(pass, band, band_count); i < end; i++) {
+        counts[(pass->keys[i] >> pass->shift) & (RADIX_BUCKETS - 1)]++;
+    }
+}
+
+static void radix_scatter_band(void* context, int band, int band_count) {
+    RadixPass* pass = (RadixPass*)context;
+    int* positions = pass->offsets + (size_t)band * RADIX_BUCKETS;
+    int end = radix_band_start(pass, band + 1, band_count);
+    
+    for (int i = radix_band_start(pass, band, band_count); i < end; i++) {
+        int position = positions[(pass->keys[i] >> pass->shift) & (RADIX_BUCKETS - 1)]++;
+        pass->out_keys[position] = pass->keys[i];
+        pass->out_values[position] = pass->values[i];
+    }
+}
+
+void radix_sort_pairs(uint32_t* keys, uint32_t* values, uint32_t* scratch_keys, uint32_t* scratch_values,
+                      int count) {
+    if (keys == NULL || values == NULL || count <= 1) return;
+    
+    int band_count = get_thread_count() * BANDS_PER_THREAD;
+    if (band_count > count / RADIX_SORT_MIN_BAND) band_count = count / RADIX_SORT_MIN_BAND;
+    if (band_count < 1) band_count = 1;
+    
+    RadixPass pass;
+    pass.offsets = (int*)safe_malloc((size_t)band_count * RADIX_BUCKETS * sizeof(int));
+    if (pass.offsets == NULL) return;
+    pass.count = count;
+    pass.keys = keys;
+    pass.values = values;
+    pass.out_keys = scratch_keys;
+    pass.out_values = scratch_values;
+    
+    for (pass.shift = 0; pass.shift < 32; pass.shift += RADIX_BITS) {
+        run_parallel(radix_count_band, &pass, band_count);
+        
+        // Digit-major, band-minor prefix sums. A digit every key shares
+        // would leave the order as it is.
+        int position = 0;
+        int skip = 0;
+        for (int digit = 0; digit < RADIX_BUCKETS; digit++) {
+            int digit_start = position;
+            for (int band = 0; band < band_count; band++) {
+                int* slot = &pass.offsets[(size_t)band * RADIX_BUCKETS + digit];
+                int band_digits = *slot;
+                *slot = position;
+                position += band_digits;
+            }
+            if (position - digit_start == count) skip = 1;
+        }
+        if (skip) continue;
+        
+        run_parallel(radix_scatter_band, &pass, band_count);
+        
+        uint32_t* swap_keys = (uint32_t*)pass.keys;
+        uint32_t* swap_values = (uint32_t*)pass.values;
+        pass.keys = pass.out_keys;
+        pass.values = pass.out_values;
+        pass.out_keys = swap_keys;
+        pass.out_values = swap_values;
+    }
+    
+    if (pass.keys != keys) {
+        memcpy(keys, pass.keys, (size_t)count * sizeof(uint32_t));
+        memcpy(values, pass.values, (size_t)count * sizeof(uint32_t));
+    }
+    safe_free(pass.offsets);
+}
+
+// Spatial keys
+uint32_t hilbert_index(int x, int y) {
+    uint32_t ux = (uint32_t)x & 0xFFFF;
+    uint32_t uy = (uint32_t)y & 0xFFFF;
+    uint32_t index = 0;
+    
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        uint32_t rx = (ux & s) ? 1 : 0;
+        uint32_t ry = (uy & s) ? 1 : 0;
+        index += s * s * ((3 * rx) ^ ry);
+        
+        // Rotate the quadrant so the curve continues from where it entered
+        if (ry == 0) {
+            if (rx == 1) {
+                ux = 0xFFFF - ux;
+                uy = 0xFFFF - uy;
+            }
+            uint32_t t = ux;
+            ux = uy;
+            uy = t;
+        }
+    }
+    return index;
+}
+
 // Searching algorithms
 Ant* binary_search_ant_by_id(Ant** sorted_ants, int count, int target_id) {
     if (sorted_ants == NULL || count <= 0) return NULL;
@@ -75,48 +199,37 @@ Ant* binary_search_ant_by_id(Ant** sorted_ants, int count, int target_id) {
     return NULL; // Ant not found
 }
 
-Ant* linear_search_ant_by_id(Ant* head, int target_id) {
-    if (head == NULL) return NULL;
+int linear_search_ant_by_id(const Colony* colony, int target_id) {
+    if (colony == NULL) return -1;
     
-    Ant* current = head;
-    while (current != NULL) {
-        if (current->id == target_id) {
-            return current;
+    const int32_t* ids = colony->ants.id;
+    for (int index = 0; index < colony->ants.count; index++) {
+        if (ids[index] == target_id) {
+            return index;
         }
-        current = current->next;
     }
     
-    return NULL; // Ant not found
+    return -1; // Ant not found
 }
 
-// Linked list utilities
-Ant** list_to_array(Ant* head, int* count) {
-    if (head == NULL || count == NULL) return NULL;
-    
-    // Count ants in list
-    *count = 0;
-    Ant* current = head;
-    while (current != NULL) {
-        (*count)++;
-        current = current->next;
-    }
+// Ant store utilities
+Ant** ants_to_array(const Colony* colony, int* count) {
+    if (colony == NULL || count == NULL) return NULL;
     
+    *count = colony->ants.count;
     if (*count == 0) return NULL;
     
-    // Allocate array of ant pointers
-    Ant** array = (Ant**)safe_malloc(*count * sizeof(Ant*));
+    // Pointer array followed by the snapshots it points at
+    Ant** array = (Ant**)safe_malloc(*count * (sizeof(Ant*) + sizeof(Ant)));
     if (array == NULL) {
         *count = 0;
         return NULL;
     }
     
-    // Fill array with ant pointers
-    current = head;
-    int index = 0;
-    while (current != NULL && index < *count) {
-        array[index] = current;
-        current = current->next;
-        index++;
+    Ant* snapshots = (Ant*)(array + *count);
+    for (int index = 0; index < *count; index++) {
+        get_ant(colony, index, &snapshots[index]);
+        array[index] = &snapshots[index];
     }
     
     return array;
@@ -8,12 +8,23 @@ void quicksort_ants_by_efficiency(Ant** ants, int left, int right);
 int partition_ants(Ant** ants, int left, int right);
 void sort_ants_by_efficiency(Ant** ants, int count);
 
+// Stable LSD radix sort of count keys, carrying a value with each, on the
+// thread pool. The scratch arrays need room for count entries; the
+// result ends up in keys and values.
+void radix_sort_pairs(uint32_t* keys, uint32_t* values, uint32_t* scratch_keys, uint32_t* scratch_values,
+                      int count);
+
+// Spatial keys: position along a Hilbert curve over the 65536 x 65536
+// grid, so cells close on the curve are close in the grid
+uint32_t hilbert_index(int x, int y);
+
 // Searching algorithms
 Ant* binary_search_ant_by_id(Ant** sorted_ants, int count, int target_id);
-Ant* linear_search_ant_by_id(Ant* head, int target_id);
+int linear_search_ant_by_id(const Colony* colony, int target_id);
 
-// Linked list utilities
-Ant** list_to_array(Ant* head, int* count);
+// Ant store utilities. ants_to_array returns pointers to snapshots of the
+// colony's ants; the snapshots share the array's allocation.
+Ant** ants_to_array(const Colony* colony, int* count);
 void free_ant_array(Ant** array);
 
 // Pathfinding algorithms
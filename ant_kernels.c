@@ -0,0 +1,264 @@
+#include "ant_kernels.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+// SIMD paths are only built for x86 targets
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ANT_SIMD_X86 1
+    #include <immintrin.h>
+#else
+    #define ANT_SIMD_X86 0
+#endif
+
+// GCC and Clang need per-function ISA targets; MSVC accepts the intrinsics as is
+#if ANT_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SIMD_TARGET_AVX2
+#endif
+
+// Scalar reference kernel
+static void decide_ant(AntDecisionBatch* batch, int i) {
+    float energy = batch->energy[i] - ANT_ENERGY_PER_STEP;
+    batch->energy[i] = energy;
+    batch->direction[i] = -1;
+
+    if (energy <= 0) {
+        batch->outcome[i] = ANT_DECISION_DEAD;
+        return;
+    }
+
+    int outcome = (energy < ANT_TIRED_ENERGY) ? ANT_DECISION_TIRED : 0;
+    if (batch->behavior[i] != ANT_BEHAVIOR_IDLE) {
+        int mask = batch->walk_mask[i];
+
+        // Strongest walkable trail
+        float best_level = 0.0f;
+        int best = -1;
+        for (int d = 0; d < 8; d++) {
+            if ((mask & (1 << d)) && batch->levels[d][i] > best_level) {
+                best_level = batch->levels[d][i];
+                best = d;
+            }
+        }
+
+        int follow = batch->behavior[i] == ANT_BEHAVIOR_RETURN ||
+                     RANDOM_DRAW_UNIT(batch->follow_draw[i]) < FOLLOW_PHEROMONE_PROBABILITY;
+        if (follow && best >= 0) {
+            batch->direction[i] = best;
+            outcome |= ANT_DECISION_FOLLOWED;
+        } else {
+            // The k-th walkable direction; none if the ant is boxed in
+            int k = RANDOM_DRAW_BELOW(batch->direction_draw[i], count_set_bits((uint64_t)mask));
+            for (int d = 0; d < 8; d++) {
+                if ((mask & (1 << d)) && k-- == 0) {
+                    batch->direction[i] = d;
+                    break;
+                }
+            }
+        }
+    }
+    batch->outcome[i] = outcome;
+}
+
+static void decide_scalar(AntDecisionBatch* batch, int count) {
+    for (int i = 0; i < count; i++) {
+        decide_ant(batch, i);
+    }
+}
+
+static const AntKernels scalar_kernels = {
+    "scalar",
+    decide_scalar
+};
+
+#if ANT_SIMD_X86
+// AVX2: eight ants per iteration. Branches become lane masks, and the
+// direction searches run over all 8 directions with blends, which keeps
+// the first-on-ties order of the scalar loops.
+
+// RANDOM_DRAW_BELOW for each lane: the high half of the 64-bit product
+SIMD_TARGET_AVX2 static __m256i draw_below_avx2(__m256i draws, __m256i n) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(draws, n), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(draws, 32), _mm256_srli_epi64(n, 32));
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+SIMD_TARGET_AVX2 static void decide_avx2(AntDecisionBatch* batch, int count) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 energy = _mm256_sub_ps(_mm256_loadu_ps(batch->energy + i),
+                                      _mm256_set1_ps((float)ANT_ENERGY_PER_STEP));
+        _mm256_storeu_ps(batch->energy + i, energy);
+        __m256i dead = _mm256_castps_si256(_mm256_cmp_ps(energy, zero, _CMP_LE_OQ));
+        __m256i tired = _mm256_castps_si256(_mm256_cmp_ps(energy, _mm256_set1_ps(ANT_TIRED_ENERGY), _CMP_LT_OQ));
+
+        __m256i mask = _mm256_loadu_si256((const __m256i*)(batch->walk_mask + i));
+        __m256i behavior = _mm256_loadu_si256((const __m256i*)(batch->behavior + i));
+
+        // Strongest walkable trail, and the number of walkable directions
+        __m256 best_level = zero;
+        __m256i best = none;
+        __m256i walkable_count = _mm256_setzero_si256();
+        for (int d = 0; d < 8; d++) {
+            __m256i bit = _mm256_and_si256(_mm256_srli_epi32(mask, d), one);
+            __m256 walkable = _mm256_castsi256_ps(_mm256_cmpeq_epi32(bit, one));
+            __m256 level = _mm256_and_ps(_mm256_loadu_ps(batch->levels[d] + i), walkable);
+            __m256 greater = _mm256_cmp_ps(level, best_level, _CMP_GT_OQ);
+            best_level = _mm256_blendv_ps(best_level, level, greater);
+            best = _mm256_blendv_epi8(best, _mm256_set1_epi32(d), _mm256_castps_si256(greater));
+            walkable_count = _mm256_add_epi32(walkable_count, bit);
+        }
+
+        // The k-th walkable direction
+        __m256i k = draw_below_avx2(_mm256_loadu_si256((const __m256i*)(batch->direction_draw + i)),
+                                    walkable_count);
+        __m256i wander = none;
+        __m256i seen = _mm256_setzero_si256();
+        for (int d = 0; d < 8; d++) {
+            __m256i bit = _mm256_and_si256(_mm256_srli_epi32(mask, d), one);
+            __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi32(bit, one), _mm256_cmpeq_epi32(seen, k));
+            wander = _mm256_blendv_epi8(wander, _mm256_set1_epi32(d), hit);
+            seen = _mm256_add_epi32(seen, bit);
+        }
+
+        // Follow-or-wander
+        __m256i follow_draw = _mm256_loadu_si256((const __m256i*)(batch->follow_draw + i));
+        __m256 unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(follow_draw, 8)),
+                                    _mm256_set1_ps(1.0f / 16777216.0f));
+        __m256i follow = _mm256_or_si256(
+            _mm256_cmpeq_epi32(behavior, _mm256_set1_epi32(ANT_BEHAVIOR_RETURN)),
+            _mm256_castps_si256(_mm256_cmp_ps(unit, _mm256_set1_ps(FOLLOW_PHEROMONE_PROBABILITY), _CMP_LT_OQ)));
+        __m256i moving = _mm256_andnot_si256(
+            _mm256_or_si256(dead, _mm256_cmpeq_epi32(behavior, _mm256_set1_epi32(ANT_BEHAVIOR_IDLE))), none);
+        __m256i followed = _mm256_and_si256(_mm256_and_si256(follow, moving), _mm256_cmpgt_epi32(best, none));
+
+        __m256i direction = _mm256_blendv_epi8(wander, best, followed);
+        direction = _mm256_blendv_epi8(none, direction, moving);
+        __m256i outcome = _mm256_or_si256(
+            _mm256_and_si256(tired, _mm256_set1_epi32(ANT_DECISION_TIRED)),
+            _mm256_and_si256(followed, _mm256_set1_epi32(ANT_DECISION_FOLLOWED)));
+        outcome = _mm256_blendv_epi8(outcome, _mm256_set1_epi32(ANT_DECISION_DEAD), dead);
+
+        _mm256_storeu_si256((__m256i*)(batch->direction + i), direction);
+        _mm256_storeu_si256((__m256i*)(batch->outcome + i), outcome);
+    }
+    for (; i < count; i++) {
+        decide_ant(batch, i);
+    }
+}
+
+static const AntKernels avx2_kernels = {
+    "AVX2",
+    decide_avx2
+};
+#endif // ANT_SIMD_X86
+
+// Kernel selection
+static const AntKernels* active_kernels = &scalar_kernels;
+
+void init_ant_kernels(void) {
+    active_kernels = &scalar_kernels;
+
+#if ANT_SIMD_X86
+    if (cpu_has_avx2()) {
+        active_kernels = &avx2_kernels;
+    }
+#endif
+
+    print_info("Ant kernels: %s", active_kernels->name);
+}
+
+const AntKernels* get_ant_kernels(void) {
+    return active_kernels;
+}
+
+const AntKernels* get_scalar_ant_kernels(void) {
+    return &scalar_kernels;
+}
+
+// Equivalence check. Inputs are drawn from small sets so that ties,
+// empty trails, boxed-in ants and the energy thresholds all come up.
+static void fill_check_batch(AntDecisionBatch* batch) {
+    for (int i = 0; i < ANT_KERNEL_BATCH; i++) {
+        for (int d = 0; d < 8; d++) {
+            uint32_t r = random_uint32();
+            batch->levels[d][i] = (r & 3) ? (float)((r >> 2) & 7) * 12.5f : 0.0f;
+        }
+
+        uint32_t r = random_uint32();
+        switch (r & 7) {
+            case 0: batch->walk_mask[i] = 0; break;
+            case 1: batch->walk_mask[i] = 0xFF; break;
+            default: batch->walk_mask[i] = (int32_t)((r >> 3) & 0xFF); break;
+        }
+        batch->behavior[i] = random_int(ANT_BEHAVIOR_IDLE, ANT_BEHAVIOR_RETURN);
+        batch->follow_draw[i] = random_uint32();
+        batch->direction_draw[i] = (r & 0x800) ? 0xFFFFFFFFu : random_uint32();
+        batch->energy[i] = (float)random_int(-2, (int)ANT_TIRED_ENERGY + 3) + ((r & 0x1000) ? 0.5f : 0.0f);
+    }
+}
+
+static int compare_batches(const AntKernels* kernels, const AntDecisionBatch* expected,
+                           const AntDecisionBatch* actual, int count) {
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        if (memcmp(&expected->energy[i], &actual->energy[i], sizeof(float)) != 0 ||
+            expected->direction[i] != actual->direction[i] ||
+            expected->outcome[i] != actual->outcome[i]) {
+            if (mismatches == 0) {
+                print_error("Ant kernel %s: ant %d got direction %d, outcome %d, energy %.1f; "
+                            "expected %d, %d, %.1f", kernels->name, i,
+                            actual->direction[i], actual->outcome[i], actual->energy[i],
+                            expected->direction[i], expected->outcome[i], expected->energy[i]);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int check_ant_kernels(int rounds) {
+    const AntKernels* candidates[2];
+    int candidate_count = 0;
+#if ANT_SIMD_X86
+    if (cpu_has_avx2()) {
+        candidates[candidate_count++] = &avx2_kernels;
+    }
+#endif
+    if (candidate_count == 0) {
+        print_info("Ant kernels: only the scalar reference is supported here");
+        return 0;
+    }
+
+    AntDecisionBatch input, expected, actual;
+    int total_mismatches = 0;
+    for (int c = 0; c < candidate_count; c++) {
+        int mismatches = 0;
+        for (int round = 0; round < rounds; round++) {
+            // Shorter batches exercise the scalar tail of the SIMD kernels
+            int count = ANT_KERNEL_BATCH - round % 8;
+            fill_check_batch(&input);
+
+            expected = input;
+            scalar_kernels.decide(&expected, count);
+            actual = input;
+            candidates[c]->decide(&actual, count);
+            mismatches += compare_batches(candidates[c], &expected, &actual, count);
+        }
+
+        if (mismatches == 0) {
+            print_info("Ant kernel %s matches the scalar reference (%d batches)", candidates[c]->name, rounds);
+        } else {
+            print_error("Ant kernel %s: %d ants in %d batches differ from the scalar reference",
+                        candidates[c]->name, mismatches, rounds);
+        }
+        total_mismatches += mismatches;
+    }
+    return total_mismatches;
+}
@@ -0,0 +1,57 @@
+#ifndef ANT_KERNELS_H
+#define ANT_KERNELS_H
+
+#include "config.h"
+#include <stdint.h>
+
+// How an ant uses its move this step
+#define ANT_BEHAVIOR_IDLE    0  // Stays put
+#define ANT_BEHAVIOR_SEARCH  1  // Follows its trail with FOLLOW_PHEROMONE_PROBABILITY, else wanders
+#define ANT_BEHAVIOR_RETURN  2  // Always follows its trail
+
+// Decision outcome flags
+#define ANT_DECISION_DEAD      0x01  // Out of energy; nothing else is decided
+#define ANT_DECISION_TIRED     0x02  // Energy below ANT_TIRED_ENERGY
+#define ANT_DECISION_FOLLOWED  0x04  // direction is the strongest trail
+
+// The per-ant arithmetic of an ant step for up to ANT_KERNEL_BATCH ants,
+// one array entry per ant. Everything that touches the world (gathering
+// levels and walk masks, then moving) is left to the caller.
+typedef struct {
+    // Inputs
+    float levels[8][ANT_KERNEL_BATCH];         // Trail level in each direction (dx/dy order)
+    int32_t walk_mask[ANT_KERNEL_BATCH];       // Bit d: direction d is walkable
+    int32_t behavior[ANT_KERNEL_BATCH];        // ANT_BEHAVIOR_*
+    uint32_t follow_draw[ANT_KERNEL_BATCH];    // Follow-or-wander choice
+    uint32_t direction_draw[ANT_KERNEL_BATCH]; // Random direction
+
+    // Updated in place
+    float energy[ANT_KERNEL_BATCH];
+
+    // Outputs
+    int32_t direction[ANT_KERNEL_BATCH];       // 0-7, or -1 to stay put
+    int32_t outcome[ANT_KERNEL_BATCH];         // ANT_DECISION_* flags
+} AntDecisionBatch;
+
+// Every implementation produces bit-identical results; the fastest one
+// supported by the CPU is selected at startup by init_ant_kernels().
+typedef struct {
+    const char* name;
+
+    // For each of the first count ants: spend a step's energy, then unless
+    // the ant died pick the strongest walkable trail (the first on ties)
+    // or, when not following or no trail is above 0, a uniformly random
+    // walkable direction
+    void (*decide)(AntDecisionBatch* batch, int count);
+} AntKernels;
+
+// Kernel selection
+void init_ant_kernels(void);
+const AntKernels* get_ant_kernels(void);
+const AntKernels* get_scalar_ant_kernels(void);
+
+// Run every kernel the CPU supports on random batches and compare it with
+// the scalar reference; returns the number of mismatching ants
+int check_ant_kernels(int rounds);
+
+#endif // ANT_KERNELS_H
@@ -3,6 +3,11 @@
 #include "utils.h"
 #include "pheromones.h"
 #include "world.h"
+#include "slab_pool.h"
+#include "thread_pool.h"
+#include "ant_kernels.h"
+#include "trace_log.h"
+#include "algorithms.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,289 +16,703 @@
 const int dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
 const int dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
 
+// Ant step: random draws per ant and the kinds of AntEvent record
+#define ANT_STEP_DRAWS 2  // Follow-or-wander choice, random direction
+#define ANT_EVENT_PICKUP    0x01
+#define ANT_EVENT_DELIVERY  0x02
+#define ANT_EVENT_DEPOSIT   0x04
+
+static int reserve_path_histories(Colony* colony);
+static void index_ant_id(AntStore* store, int index);
+static void unindex_ant_id(AntStore* store, int index);
+static void repoint_ant_id(AntStore* store, int from, int to);
+static void rebuild_id_index(AntStore* store);
+
+// Ant store
+#define ANT_ARRAY_BYTES(capacity, type) \
+    (((size_t)(capacity) * sizeof(type) + GRID_ALIGNMENT - 1) & ~(size_t)(GRID_ALIGNMENT - 1))
+
+// The id index is kept at most half full
+static int id_index_bits(int capacity) {
+    int bits = 1;
+    while ((1 << bits) < 2 * capacity) {
+        bits++;
+    }
+    return bits;
+}
+
+// Size of the single block holding every array for capacity ants
+static size_t ant_block_size(int capacity) {
+    return 8 * ANT_ARRAY_BYTES(capacity, int32_t) + ANT_ARRAY_BYTES(capacity, float) +
+           ANT_ARRAY_BYTES(capacity, uint8_t) + ANT_ARRAY_BYTES(capacity, PathHistory*) +
+           ANT_ARRAY_BYTES(1 << id_index_bits(capacity), int32_t);
+}
+
+// Point every array of store into block, each on its own cache line
+static void assign_ant_arrays(AntStore* store, char* block, int capacity) {
+    store->block = block;
+    store->id = (int32_t*)block;               block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->x = (int32_t*)block;                block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->y = (int32_t*)block;                block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->last_x = (int32_t*)block;           block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->last_y = (int32_t*)block;           block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->food_carrying = (int32_t*)block;    block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->steps_taken = (int32_t*)block;      block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->food_delivered = (int32_t*)block;   block += ANT_ARRAY_BYTES(capacity, int32_t);
+    store->energy = (float*)block;             block += ANT_ARRAY_BYTES(capacity, float);
+    store->state = (uint8_t*)block;            block += ANT_ARRAY_BYTES(capacity, uint8_t);
+    store->path_history = (PathHistory**)block; block += ANT_ARRAY_BYTES(capacity, PathHistory*);
+    store->id_index = (int32_t*)block;
+    store->id_index_bits = id_index_bits(capacity);
+    store->capacity = capacity;
+}
+
+int reserve_ants(AntStore* store, int capacity) {
+    if (store == NULL) return 0;
+    if (capacity <= store->capacity) return 1;
+    
+    char* block = (char*)safe_aligned_calloc(1, ant_block_size(capacity), GRID_ALIGNMENT);
+    if (block == NULL) {
+        return 0;
+    }
+    
+    AntStore grown = *store;
+    assign_ant_arrays(&grown, block, capacity);
+    size_t count = (size_t)store->count;
+    if (count > 0) {
+        memcpy(grown.id, store->id, count * sizeof(int32_t));
+        memcpy(grown.x, store->x, count * sizeof(int32_t));
+        memcpy(grown.y, store->y, count * sizeof(int32_t));
+        memcpy(grown.last_x, store->last_x, count * sizeof(int32_t));
+        memcpy(grown.last_y, store->last_y, count * sizeof(int32_t));
+        memcpy(grown.food_carrying, store->food_carrying, count * sizeof(int32_t));
+        memcpy(grown.steps_taken, store->steps_taken, count * sizeof(int32_t));
+        memcpy(grown.food_delivered, store->food_delivered, count * sizeof(int32_t));
+        memcpy(grown.energy, store->energy, count * sizeof(float));
+        memcpy(grown.state, store->state, count * sizeof(uint8_t));
+        memcpy(grown.path_history, store->path_history, count * sizeof(PathHistory*));
+    }
+    rebuild_id_index(&grown);
+    
+    safe_aligned_free(store->block);
+    *store = grown;
+    return 1;
+}
+
+// Path histories live in the colony's slab pool, so dropping every ant
+// only releases the store block and the pool's slabs
+void release_colony_ants(Colony* colony) {
+    if (colony == NULL) return;
+    
+    safe_aligned_free(colony->ants.block);
+    memset(&colony->ants, 0, sizeof(AntStore));
+    safe_aligned_free(colony->step_buffers.block);
+    memset(&colony->step_buffers, 0, sizeof(AntStepBuffers));
+    release_slab_pool(&colony->path_pool);
+    colony->total_ants = 0;
+    colony->active_ants = 0;
+}
+
+// Append count fresh ants at pos to a store with room for them
+static void fill_ants(Colony* colony, Position pos, int count) {
+    AntStore* ants = &colony->ants;
+    int first = ants->count;
+    int end = first + count;
+    
+    for (int index = first; index < end; index++) {
+        ants->id[index] = ++ants->last_id;
+        ants->x[index] = pos.x;
+        ants->y[index] = pos.y;
+        ants->last_x[index] = pos.x;
+        ants->last_y[index] = pos.y;
+        ants->energy[index] = ANT_INITIAL_ENERGY;
+        index_ant_id(ants, index);
+    }
+    memset(ants->state + first, ANT_STATE_SEARCHING, (size_t)count);  // Start searching for food
+    memset(ants->food_carrying + first, 0, (size_t)count * sizeof(int32_t));
+    memset(ants->steps_taken + first, 0, (size_t)count * sizeof(int32_t));
+    memset(ants->food_delivered + first, 0, (size_t)count * sizeof(int32_t));
+    memset(ants->path_history + first, 0, (size_t)count * sizeof(PathHistory*));
+    
+    ants->count = end;
+    colony->total_ants += count;
+    colony->active_ants += count;
+}
+
 // Ant creation and management
-Ant* create_ant(int id, int colony_id, Position pos) {
-    Ant* ant = (Ant*)safe_malloc(sizeof(Ant));
-    if (ant == NULL) {
-        return NULL;
+int add_ant(Colony* colony, Position pos) {
+    if (colony == NULL) return -1;
+    
+    AntStore* ants = &colony->ants;
+    if (ants->count == ants->capacity) {
+        int capacity = (ants->capacity > 0) ? ants->capacity * 2 : DEFAULT_ANTS_PER_COLONY;
+        if (capacity > MAX_ANTS_PER_COLONY) capacity = MAX_ANTS_PER_COLONY;
+        if (ants->count == capacity || !reserve_ants(ants, capacity)) {
+            return -1;
+        }
     }
     
-    // Initialize ant properties
-    ant->id = id;
-    ant->pos = pos;
-    ant->position = pos;  // Keep both fields in sync
-    ant->last_pos = pos;
-    ant->state = ANT_STATE_SEARCHING;  // Start searching for food
-    ant->colony_id = colony_id;
-    ant->energy = ANT_INITIAL_ENERGY;
-    ant->food_carrying = 0;
-    ant->steps_taken = 0;
-    ant->food_delivered = 0;
-    ant->next = NULL;
-    ant->path_history = NULL;
+    int index = ants->count;
+    fill_ants(colony, pos, 1);
     
-    print_info("Ant %d created for colony %d at (%d, %d)", id, colony_id, pos.x, pos.y);
-    return ant;
+    LOG_DEBUG("Ant %d added to colony %d at (%d, %d)", ants->id[index], colony->id, pos.x, pos.y);
+    return index;
 }
 
-void destroy_ant(Ant* ant) {
-    if (ant == NULL) return;
+int restore_ant(Colony* colony, const Ant* ant) {
+    if (colony == NULL || ant == NULL) return -1;
     
-    // Clear path history
-    clear_path_history(ant);
+    int index = add_ant(colony, ant->pos);
+    if (index < 0) return -1;
     
-    // Free the ant
-    safe_free(ant);
+    AntStore* ants = &colony->ants;
+    unindex_ant_id(ants, index);
+    ants->id[index] = ant->id;
+    index_ant_id(ants, index);
+    if (ant->id > ants->last_id) {
+        ants->last_id = ant->id;
+    }
+    ants->last_x[index] = ant->last_pos.x;
+    ants->last_y[index] = ant->last_pos.y;
+    ants->state[index] = ant->state;
+    ants->energy[index] = ant->energy;
+    ants->food_carrying[index] = ant->food_carrying;
+    ants->steps_taken[index] = ant->steps_taken;
+    ants->food_delivered[index] = ant->food_delivered;
+    return index;
 }
 
-void add_ant_to_colony(Colony* colony, Ant* ant) {
-    if (colony == NULL || ant == NULL) return;
+void remove_ant(Colony* colony, int index) {
+    if (colony == NULL || index < 0 || index >= colony->ants.count) return;
     
-    // Add to front of linked list
-    ant->next = colony->ants_head;
-    colony->ants_head = ant;
+    AntStore* ants = &colony->ants;
+    int id = ants->id[index];
+    clear_path_history(colony, index);
+    unindex_ant_id(ants, index);
     
-    colony->total_ants++;
-    colony->active_ants++;
+    // Swap-remove: the last ant takes over the freed slot
+    int last = --ants->count;
+    if (index != last) {
+        repoint_ant_id(ants, last, index);
+        ants->id[index] = ants->id[last];
+        ants->x[index] = ants->x[last];
+        ants->y[index] = ants->y[last];
+        ants->last_x[index] = ants->last_x[last];
+        ants->last_y[index] = ants->last_y[last];
+        ants->state[index] = ants->state[last];
+        ants->energy[index] = ants->energy[last];
+        ants->food_carrying[index] = ants->food_carrying[last];
+        ants->steps_taken[index] = ants->steps_taken[last];
+        ants->food_delivered[index] = ants->food_delivered[last];
+        ants->path_history[index] = ants->path_history[last];
+    }
+    
+    colony->total_ants--;
+    colony->active_ants--;
+    LOG_DEBUG("Ant %d removed from colony %d", id, colony->id);
+}
+
+void get_ant(const Colony* colony, int index, Ant* ant) {
+    if (colony == NULL || ant == NULL || index < 0 || index >= colony->ants.count) return;
     
-    print_info("Ant %d added to colony %d", ant->id, colony->id);
+    const AntStore* ants = &colony->ants;
+    ant->id = ants->id[index];
+    ant->pos.x = ants->x[index];
+    ant->pos.y = ants->y[index];
+    ant->last_pos.x = ants->last_x[index];
+    ant->last_pos.y = ants->last_y[index];
+    ant->state = ants->state[index];
+    ant->colony_id = colony->id;
+    ant->energy = ants->energy[index];
+    ant->food_carrying = ants->food_carrying[index];
+    ant->steps_taken = ants->steps_taken[index];
+    ant->food_delivered = ants->food_delivered[index];
+}
+
+// Ant id index: linear probing over slots, keyed by id[slot]. Only slots
+// are stored, so entries follow the id array and moving an ant means
+// repointing its one entry.
+static uint32_t id_index_home(const AntStore* store, int32_t id) {
+    return ((uint32_t)id * 0x9E3779B9u) >> (32 - store->id_index_bits);
+}
+
+static uint32_t find_id_entry(const AntStore* store, int index) {
+    uint32_t mask = (1u << store->id_index_bits) - 1;
+    uint32_t entry = id_index_home(store, store->id[index]);
+    while (store->id_index[entry] != index) {
+        entry = (entry + 1) & mask;
+    }
+    return entry;
 }
 
-void remove_ant_from_colony(Colony* colony, Ant* ant) {
-    if (colony == NULL || ant == NULL) return;
+static void index_ant_id(AntStore* store, int index) {
+    uint32_t mask = (1u << store->id_index_bits) - 1;
+    uint32_t entry = id_index_home(store, store->id[index]);
+    while (store->id_index[entry] >= 0) {
+        entry = (entry + 1) & mask;
+    }
+    store->id_index[entry] = index;
+}
+
+// Drop the ant's entry, shifting later entries of its probe run back so
+// that no lookup stops short at the hole
+static void unindex_ant_id(AntStore* store, int index) {
+    uint32_t mask = (1u << store->id_index_bits) - 1;
+    uint32_t hole = find_id_entry(store, index);
     
-    // Find and remove from linked list
-    Ant** current = &colony->ants_head;
-    while (*current != NULL && *current != ant) {
-        current = &(*current)->next;
+    for (uint32_t entry = (hole + 1) & mask; store->id_index[entry] >= 0; entry = (entry + 1) & mask) {
+        uint32_t home = id_index_home(store, store->id[store->id_index[entry]]);
+        if (((entry - home) & mask) >= ((entry - hole) & mask)) {
+            store->id_index[hole] = store->id_index[entry];
+            hole = entry;
+        }
+    }
+    store->id_index[hole] = -1;
+}
+
+// The ant in slot from is about to be copied to slot to
+static void repoint_ant_id(AntStore* store, int from, int to) {
+    store->id_index[find_id_entry(store, from)] = to;
+}
+
+static void rebuild_id_index(AntStore* store) {
+    memset(store->id_index, 0xFF, ((size_t)1 << store->id_index_bits) * sizeof(int32_t));
+    for (int index = 0; index < store->count; index++) {
+        index_ant_id(store, index);
     }
+}
+
+int find_ant_by_id(const Colony* colony, int id) {
+    if (colony == NULL || colony->ants.capacity == 0) return -1;
     
-    if (*current != NULL) {
-        *current = ant->next;
-        colony->active_ants--;
-        print_info("Ant %d removed from colony %d", ant->id, colony->id);
+    const AntStore* ants = &colony->ants;
+    uint32_t mask = (1u << ants->id_index_bits) - 1;
+    for (uint32_t entry = id_index_home(ants, id); ; entry = (entry + 1) & mask) {
+        int32_t index = ants->id_index[entry];
+        if (index < 0) return -1;
+        if (ants->id[index] == id) return index;
     }
 }
 
 // Ant movement
-void move_ant(Ant* ant, World* world, int direction) {
-    if (ant == NULL || world == NULL || direction < 0 || direction >= 8) {
+void move_ant(World* world, Colony* colony, int index, int direction) {
+    if (world == NULL || colony == NULL || direction < 0 || direction >= 8) {
         return;
     }
     
+    AntStore* ants = &colony->ants;
+    
     // Store last position
-    ant->last_pos = ant->pos;
+    ants->last_x[index] = ants->x[index];
+    ants->last_y[index] = ants->y[index];
     
     // Calculate new position
-    int new_x = ant->pos.x + dx[direction];
-    int new_y = ant->pos.y + dy[direction];
+    int new_x = ants->x[index] + dx[direction];
+    int new_y = ants->y[index] + dy[direction];
     
     // Check if new position is valid and walkable
     if (is_valid_position(world, new_x, new_y) && is_walkable(world, new_x, new_y)) {
-        ant->pos.x = new_x;
-        ant->pos.y = new_y;
-        ant->position.x = new_x;  // Keep both fields in sync
-        ant->position.y = new_y;
-        ant->steps_taken++;
+        ants->x[index] = new_x;
+        ants->y[index] = new_y;
+        ants->steps_taken[index]++;
         
         // Add to path history
-        add_path_node(ant, ant->pos, 0.0f);
+        Position pos = { new_x, new_y };
+        record_path_position(colony, index, pos);
         
-        print_info("Ant %d moved to (%d, %d)", ant->id, new_x, new_y);
+        TRACE_ANT_EVENT(TRACE_EVENT_MOVE, colony->id, ants->id[index], new_x, new_y,
+                        world->current_step, direction);
+        LOG_TRACE("Ant %d moved to (%d, %d)", ants->id[index], new_x, new_y);
     } else {
-        print_warning("Ant %d cannot move to (%d, %d)", new_x, new_y);
+        LOG_DEBUG("Ant %d cannot move to (%d, %d)", ants->id[index], new_x, new_y);
     }
 }
 
-void move_randomly(Ant* ant, World* world) {
-    if (ant == NULL || world == NULL) return;
-    
-    // Try random directions until we find a valid one
-    int attempts = 0;
-    const int max_attempts = 10;
-    
-    while (attempts < max_attempts) {
-        int direction = random_int(0, 7);
-        int new_x = ant->pos.x + dx[direction];
-        int new_y = ant->pos.y + dy[direction];
-        
-        if (is_valid_position(world, new_x, new_y) && is_walkable(world, new_x, new_y)) {
-            move_ant(ant, world, direction);
-            return;
-        }
-        attempts++;
+// Step to the walkable neighbour picked by draw, uniformly among them
+static void move_in_random_direction(World* world, Colony* colony, int index, uint32_t draw) {
+    uint8_t mask = get_walk_mask(world, colony->ants.x[index], colony->ants.y[index]);
+    if (mask == 0) {
+        LOG_DEBUG("Ant %d could not find valid random direction", colony->ants.id[index]);
+        return;
     }
     
-    // If no valid direction found, don't move
-    print_warning("Ant %d could not find valid random direction", ant->id);
+    unsigned int bits = mask;
+    for (int skip = RANDOM_DRAW_BELOW(draw, count_set_bits(mask)); skip > 0; skip--) {
+        bits &= bits - 1;
+    }
+    move_ant(world, colony, index, lowest_set_bit(bits));
 }
 
-void follow_pheromone_gradient(Ant* ant, World* world, int pheromone_type) {
-    if (ant == NULL || world == NULL) return;
-    
+// follow_pheromone_gradient with the draw for the random fallback given
+static void follow_gradient(World* world, Colony* colony, int index, int pheromone_type, uint32_t draw) {
+    int x = colony->ants.x[index];
+    int y = colony->ants.y[index];
     float max_pheromone = 0.0f;
-    int best_direction = -1;
+    int best_direction = get_pheromone_gradient(world, x, y, colony->id, pheromone_type);
     
-    // Check all 8 neighboring cells
-    for (int dir = 0; dir < 8; dir++) {
-        int new_x = ant->pos.x + dx[dir];
-        int new_y = ant->pos.y + dy[dir];
+    if (best_direction >= 0) {
+        // Precomputed: a single lookup instead of the neighbour scan
+        max_pheromone = get_pheromone_intensity(world, x + dx[best_direction], y + dy[best_direction],
+                                                colony->id, pheromone_type);
+    } else if (best_direction == PHEROMONE_GRADIENT_UNKNOWN) {
+        best_direction = -1;
         
-        if (is_valid_position(world, new_x, new_y) && is_walkable(world, new_x, new_y)) {
-            float pheromone = get_pheromone_intensity(world, new_x, new_y, pheromone_type);
-            if (pheromone > max_pheromone) {
-                max_pheromone = pheromone;
-                best_direction = dir;
+        // Check all 8 neighboring cells
+        uint8_t mask = get_walk_mask(world, x, y);
+        for (int dir = 0; dir < 8; dir++) {
+            if (mask & (1 << dir)) {
+                float pheromone = get_pheromone_intensity(world, x + dx[dir], y + dy[dir],
+                                                          colony->id, pheromone_type);
+                if (pheromone > max_pheromone) {
+                    max_pheromone = pheromone;
+                    best_direction = dir;
+                }
             }
         }
     }
     
     // Move to best direction if pheromone found
     if (best_direction >= 0 && max_pheromone > 0.0f) {
-        move_ant(ant, world, best_direction);
-        print_info("Ant %d following pheromone gradient (type %d, strength %.1f)", 
-                  ant->id, pheromone_type, max_pheromone);
+        move_ant(world, colony, index, best_direction);
+        LOG_TRACE("Ant %d following pheromone gradient (type %d, strength %.1f)", 
+                  colony->ants.id[index], pheromone_type, max_pheromone);
     } else {
         // No pheromone trail found, move randomly
-        move_randomly(ant, world);
+        move_in_random_direction(world, colony, index, draw);
     }
 }
 
-// Ant behavior
-void update_ant(World* world, Ant* ant) {
-    if (world == NULL || ant == NULL) return;
+void move_randomly(World* world, Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
+    
+    move_in_random_direction(world, colony, index, random_uint32());
+}
+
+void follow_pheromone_gradient(World* world, Colony* colony, int index, int pheromone_type) {
+    if (world == NULL || colony == NULL) return;
+    
+    follow_gradient(world, colony, index, pheromone_type, random_uint32());
+}
+
+// Food and nest interactions. Each is split into the part that only
+// touches the ant and the part that touches shared state.
+static int food_available(const World* world, const Colony* colony, int index, int x, int y) {
+    // Food only ever sits in allocated tiles
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return 0;
+    
+    int cell = TILE_CELL_INDEX(x, y);
+    return tile->terrain[cell] == TERRAIN_FOOD && tile->food_amount[cell] > 0 &&
+           colony->ants.food_carrying[index] == 0;
+}
+
+static void pick_up_food(World* world, Colony* colony, int index, int x, int y) {
+    if (!food_available(world, colony, index, x, y)) return;
+    
+    AntStore* ants = &colony->ants;
+    WorldTile* tile = get_tile(world, x, y);
+    int cell = TILE_CELL_INDEX(x, y);
+    
+    // Pick up food
+    ants->food_carrying[index] = 1;
+    tile->food_amount[cell]--;
+    
+    // Change state to returning
+    clear_ant_state(colony, index, ANT_STATE_SEARCHING);
+    set_ant_state(colony, index, ANT_STATE_RETURNING);
+    
+    // Boost energy
+    ants->energy[index] += ANT_ENERGY_FROM_FOOD;
+    
+    TRACE_ANT_EVENT(TRACE_EVENT_PICKUP, colony->id, ants->id[index], x, y,
+                    world->current_step, tile->food_amount[cell]);
+    LOG_DEBUG("Ant %d picked up food at (%d, %d)", ants->id[index], x, y);
+    
+    // If food is depleted, clear the cell. Food and empty ground are
+    // both walkable, so the neighbours' walk masks stay valid.
+    if (tile->food_amount[cell] <= 0) {
+        tile->terrain[cell] = TERRAIN_EMPTY;
+    }
+}
+
+// Hand the ant's food over at its own nest; returns the amount the colony
+// is owed
+static int deliver_food(const World* world, Colony* colony, int index) {
+    AntStore* ants = &colony->ants;
+    const WorldTile* tile = get_tile(world, ants->x[index], ants->y[index]);
+    if (tile == NULL) return 0;
+    
+    int cell = TILE_CELL_INDEX(ants->x[index], ants->y[index]);
+    if (tile->terrain[cell] != TERRAIN_NEST || tile->colony_id[cell] != colony->id ||
+        ants->food_carrying[index] <= 0) {
+        return 0;
+    }
+    
+    int delivered = ants->food_carrying[index];
+    ants->food_delivered[index] += delivered;
+    ants->food_carrying[index] = 0;
+    
+    // Change state back to searching
+    clear_ant_state(colony, index, ANT_STATE_RETURNING);
+    set_ant_state(colony, index, ANT_STATE_SEARCHING);
+    
+    TRACE_ANT_EVENT(TRACE_EVENT_DELIVERY, colony->id, ants->id[index], ants->x[index], ants->y[index],
+                    world->current_step, delivered);
+    LOG_DEBUG("Ant %d delivered food to colony %d nest", ants->id[index], colony->id);
+    return delivered;
+}
+
+static void check_tired(Colony* colony, int index) {
+    if (colony->ants.energy[index] < ANT_TIRED_ENERGY) {
+        set_ant_state(colony, index, ANT_STATE_TIRED);
+    }
+}
+
+// Phase one of the ant step, in three passes over a batch of ants. Only
+// the ants themselves change; the world is only read, so any number of
+// ants can be planned at once, and their effects on shared state are
+// recorded as events.
+
+// Gather: what the decision kernel needs to know about the ant's
+// surroundings
+static void gather_ant(const World* world, const Colony* colony, int index, const uint32_t* draws,
+                       AntDecisionBatch* batch, int i) {
+    const AntStore* ants = &colony->ants;
+    int x = ants->x[index];
+    int y = ants->y[index];
     
-    // Decrease energy
-    ant->energy -= ANT_ENERGY_PER_STEP;
+    batch->energy[i] = ants->energy[index];
+    batch->follow_draw[i] = draws[0];
+    batch->direction_draw[i] = draws[1];
+    for (int d = 0; d < 8; d++) {
+        batch->levels[d][i] = 0.0f;
+    }
     
-    // Check if ant died
-    if (ant->energy <= 0) {
-        set_ant_state(ant, ANT_STATE_DEAD);
-        print_info("Ant %d died from exhaustion", ant->id);
+    int pheromone_type;
+    if (ants->state[index] & ANT_STATE_SEARCHING) {
+        batch->behavior[i] = ANT_BEHAVIOR_SEARCH;
+        pheromone_type = PHEROMONE_TYPE_FOOD;
+    } else if (ants->state[index] & ANT_STATE_RETURNING) {
+        batch->behavior[i] = ANT_BEHAVIOR_RETURN;
+        pheromone_type = PHEROMONE_TYPE_HOME;
+    } else {
+        batch->behavior[i] = ANT_BEHAVIOR_IDLE;
+        batch->walk_mask[i] = 0;
         return;
     }
     
-    // Handle current state
-    if (ant->state & ANT_STATE_SEARCHING) {
-        // Looking for food
-        handle_food_interaction(ant, world);
-        
-        // Decide movement
-        if (random_probability() < FOLLOW_PHEROMONE_PROBABILITY) {
-            follow_pheromone_gradient(ant, world, PHEROMONE_TYPE_FOOD);
+    uint8_t mask = get_walk_mask(world, x, y);
+    batch->walk_mask[i] = mask;
+    
+    // Levels are only read by an ant that follows its trail
+    if (batch->behavior[i] == ANT_BEHAVIOR_SEARCH &&
+        !(RANDOM_DRAW_UNIT(draws[0]) < FOLLOW_PHEROMONE_PROBABILITY)) {
+        return;
+    }
+    
+    int direction = get_pheromone_gradient(world, x, y, colony->id, pheromone_type);
+    if (direction >= 0) {
+        // Precomputed: a single lookup instead of the neighbour scan
+        batch->levels[direction][i] = get_pheromone_intensity(world, x + dx[direction], y + dy[direction],
+                                                              colony->id, pheromone_type);
+    } else if (direction == PHEROMONE_GRADIENT_UNKNOWN) {
+        for (int d = 0; d < 8; d++) {
+            if (mask & (1 << d)) {
+                batch->levels[d][i] = get_pheromone_intensity(world, x + dx[d], y + dy[d],
+                                                              colony->id, pheromone_type);
+            }
+        }
+    }
+}
+
+// Commit: carry out the kernel's decision for the ant. Returns 1 if event
+// needs applying.
+static int commit_ant(World* world, Colony* colony, int index, const AntDecisionBatch* batch, int i,
+                      AntEvent* event) {
+    AntStore* ants = &colony->ants;
+    event->index = index;
+    event->flags = 0;
+    
+    ants->energy[index] = batch->energy[i];
+    if (batch->outcome[i] & ANT_DECISION_DEAD) {
+        set_ant_state(colony, index, ANT_STATE_DEAD);
+        TRACE_ANT_EVENT(TRACE_EVENT_DEATH, colony->id, ants->id[index], ants->x[index], ants->y[index],
+                        world->current_step, 0);
+        LOG_DEBUG("Ant %d died from exhaustion", ants->id[index]);
+        return 0;
+    }
+    
+    if (batch->behavior[i] == ANT_BEHAVIOR_SEARCH) {
+        // Looking for food; several ants may want the last unit, so the
+        // pickup is claimed in phase two
+        if (food_available(world, colony, index, ants->x[index], ants->y[index])) {
+            event->flags |= ANT_EVENT_PICKUP;
+            event->food_x = ants->x[index];
+            event->food_y = ants->y[index];
+        }
+    } else if (batch->behavior[i] == ANT_BEHAVIOR_RETURN) {
+        // Returning with food
+        event->delivered = deliver_food(world, colony, index);
+        if (event->delivered > 0) {
+            event->flags |= ANT_EVENT_DELIVERY;
+        }
+    }
+    
+    if (batch->behavior[i] != ANT_BEHAVIOR_IDLE) {
+        int direction = batch->direction[i];
+        if (direction >= 0) {
+            move_ant(world, colony, index, direction);
+            if (batch->outcome[i] & ANT_DECISION_FOLLOWED) {
+                LOG_TRACE("Ant %d following pheromone gradient (type %d, strength %.1f)", ants->id[index],
+                           (batch->behavior[i] == ANT_BEHAVIOR_SEARCH) ? PHEROMONE_TYPE_FOOD : PHEROMONE_TYPE_HOME,
+                           batch->levels[direction][i]);
+            }
         } else {
-            move_randomly(ant, world);
+            LOG_DEBUG("Ant %d could not find valid random direction", ants->id[index]);
         }
         
-        // Deposit home pheromone
-        deposit_pheromone(world, ant);
-        
-    } else if (ant->state & ANT_STATE_RETURNING) {
-        // Returning with food
-        handle_nest_return(ant, world);
+        // Searching ants deposit home pheromone (food pheromone if the
+        // pickup succeeds), returning ones food pheromone (home pheromone
+        // after a delivery)
+        event->flags |= ANT_EVENT_DEPOSIT;
+    }
+    
+    // A pickup's energy boost has to land first
+    if (!(event->flags & ANT_EVENT_PICKUP) && (batch->outcome[i] & ANT_DECISION_TIRED)) {
+        set_ant_state(colony, index, ANT_STATE_TIRED);
+    }
+    return event->flags != 0;
+}
+
+// Plan the live ants in [first, end), given ANT_STEP_DRAWS draws for each
+// ant from first on; returns the number of events written
+static int plan_ants(World* world, Colony* colony, int first, int end, const uint32_t* draws, AntEvent* events) {
+    const AntKernels* kernels = get_ant_kernels();
+    AntDecisionBatch batch;
+    int batch_index[ANT_KERNEL_BATCH];
+    int event_count = 0;
+    
+    for (int start = first; start < end; start += ANT_KERNEL_BATCH) {
+        int stop = (start + ANT_KERNEL_BATCH < end) ? start + ANT_KERNEL_BATCH : end;
+        int count = 0;
+        for (int index = start; index < stop; index++) {
+            if (colony->ants.state[index] & ANT_STATE_DEAD) continue;
+            gather_ant(world, colony, index, draws + (size_t)(index - first) * ANT_STEP_DRAWS, &batch, count);
+            batch_index[count++] = index;
+        }
         
-        // Follow home pheromone trail
-        follow_pheromone_gradient(ant, world, PHEROMONE_TYPE_HOME);
+        kernels->decide(&batch, count);
         
-        // Deposit food pheromone
-        deposit_pheromone(world, ant);
+        for (int i = 0; i < count; i++) {
+            if (commit_ant(world, colony, batch_index[i], &batch, i, &events[event_count])) {
+                event_count++;
+            }
+        }
+    }
+    return event_count;
+}
+
+// Phase two: apply one ant's recorded effects
+static void apply_ant_event(World* world, Colony* colony, const AntEvent* event) {
+    int index = event->index;
+    
+    if (event->flags & ANT_EVENT_PICKUP) {
+        pick_up_food(world, colony, index, event->food_x, event->food_y);
+        check_tired(colony, index);
+    }
+    if (event->flags & ANT_EVENT_DELIVERY) {
+        colony->food_collected += event->delivered;
     }
+    if (event->flags & ANT_EVENT_DEPOSIT) {
+        deposit_pheromone(world, colony, index);
+    }
+}
+
+// Ant behavior
+void update_ant(World* world, Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
     
-    // Check if ant is tired
-    if (ant->energy < ANT_INITIAL_ENERGY * 0.2f) {
-        set_ant_state(ant, ANT_STATE_TIRED);
+    // The same draws the ant would get from update_all_ants
+    uint32_t draws[ANT_STEP_DRAWS];
+    fill_keyed_random_draws(draws, ANT_STEP_DRAWS, &colony->ants.id[index], 1,
+                            (uint32_t)colony->id, (uint32_t)world->current_step);
+    
+    AntEvent event;
+    if (plan_ants(world, colony, index, index + 1, draws, &event) > 0) {
+        apply_ant_event(world, colony, &event);
     }
 }
 
-void decide_direction(Ant* ant, World* world) {
-    if (ant == NULL || world == NULL) return;
+void decide_direction(World* world, Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
     
-    if (ant->state & ANT_STATE_SEARCHING) {
+    if (colony->ants.state[index] & ANT_STATE_SEARCHING) {
         // Looking for food
         if (random_probability() < FOLLOW_PHEROMONE_PROBABILITY) {
-            follow_pheromone_gradient(ant, world, PHEROMONE_TYPE_FOOD);
+            follow_pheromone_gradient(world, colony, index, PHEROMONE_TYPE_FOOD);
         } else {
-            move_randomly(ant, world);
+            move_randomly(world, colony, index);
         }
-    } else if (ant->state & ANT_STATE_RETURNING) {
+    } else if (colony->ants.state[index] & ANT_STATE_RETURNING) {
         // Returning with food
-        follow_pheromone_gradient(ant, world, PHEROMONE_TYPE_HOME);
+        follow_pheromone_gradient(world, colony, index, PHEROMONE_TYPE_HOME);
     } else {
         // Default to random movement
-        move_randomly(ant, world);
+        move_randomly(world, colony, index);
     }
 }
 
-void handle_food_interaction(Ant* ant, World* world) {
-    if (ant == NULL || world == NULL) return;
-    
-    Cell* cell = get_cell(world, ant->pos.x, ant->pos.y);
-    if (cell == NULL) return;
+void handle_food_interaction(World* world, Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
     
-    if (cell->terrain == TERRAIN_FOOD && cell->food_amount > 0 && ant->food_carrying == 0) {
-        // Pick up food
-        ant->food_carrying = 1;
-        cell->food_amount--;
-        
-        // Change state to returning
-        clear_ant_state(ant, ANT_STATE_SEARCHING);
-        set_ant_state(ant, ANT_STATE_RETURNING);
-        
-        // Boost energy
-        ant->energy += ANT_ENERGY_FROM_FOOD;
-        
-        print_info("Ant %d picked up food at (%d, %d)", ant->id, ant->pos.x, ant->pos.y);
-        
-        // If food is depleted, clear the cell
-        if (cell->food_amount <= 0) {
-            cell->terrain = TERRAIN_EMPTY;
-        }
-    }
+    pick_up_food(world, colony, index, colony->ants.x[index], colony->ants.y[index]);
 }
 
-void handle_nest_return(Ant* ant, World* world) {
-    if (ant == NULL || world == NULL) return;
-    
-    Cell* cell = get_cell(world, ant->pos.x, ant->pos.y);
-    if (cell == NULL) return;
+void handle_nest_return(World* world, Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
     
-    if (cell->terrain == TERRAIN_NEST && cell->colony_id == ant->colony_id && ant->food_carrying > 0) {
-        // Deliver food to nest
-        Colony* colony = &world->colonies[ant->colony_id];
-        colony->food_collected += ant->food_carrying;
-        ant->food_delivered += ant->food_carrying;
-        ant->food_carrying = 0;
-        
-        // Change state back to searching
-        clear_ant_state(ant, ANT_STATE_RETURNING);
-        set_ant_state(ant, ANT_STATE_SEARCHING);
-        
-        print_info("Ant %d delivered food to colony %d nest", ant->id, ant->colony_id);
-    }
+    colony->food_collected += deliver_food(world, colony, index);
 }
 
 // Ant state management
-void set_ant_state(Ant* ant, uint8_t state) {
-    if (ant == NULL) return;
-    ant->state |= state;
+void set_ant_state(Colony* colony, int index, uint8_t state) {
+    if (colony == NULL) return;
+    colony->ants.state[index] |= state;
 }
 
-void clear_ant_state(Ant* ant, uint8_t state) {
-    if (ant == NULL) return;
-    ant->state &= ~state;
+void clear_ant_state(Colony* colony, int index, uint8_t state) {
+    if (colony == NULL) return;
+    colony->ants.state[index] &= ~state;
 }
 
-int has_ant_state(const Ant* ant, uint8_t state) {
-    if (ant == NULL) return 0;
-    return (ant->state & state) != 0;
+int has_ant_state(const Colony* colony, int index, uint8_t state) {
+    if (colony == NULL) return 0;
+    return (colony->ants.state[index] & state) != 0;
 }
 
-void toggle_ant_state(Ant* ant, uint8_t state) {
-    if (ant == NULL) return;
-    ant->state ^= state;
+void toggle_ant_state(Colony* colony, int index, uint8_t state) {
+    if (colony == NULL) return;
+    colony->ants.state[index] ^= state;
 }
 
 // Colony ant management
+void set_ant_population(World* world, int initial_ants, int capacity) {
+    if (world == NULL) return;
+    
+    world->ant_capacity = clamp_int(capacity, 1, MAX_ANTS_PER_COLONY);
+    world->initial_ants = clamp_int(initial_ants, 0, world->ant_capacity);
+}
+
+static void trace_spawns(const World* world, const Colony* colony, int first, int end) {
+    if (!trace_enabled) return;
+    
+    const AntStore* ants = &colony->ants;
+    for (int index = first; index < end; index++) {
+        trace_ant_event_waiting(TRACE_EVENT_SPAWN, colony->id, ants->id[index], ants->x[index],
+                                ants->y[index], world->current_step, 0);
+    }
+}
+
 void spawn_ant(World* world, int colony_id) {
     if (world == NULL || colony_id < 0 || colony_id >= world->colony_count) {
         return;
@@ -302,38 +721,60 @@ void spawn_ant(World* world, int colony_id) {
     Colony* colony = &world->colonies[colony_id];
     
     // Check if we can spawn more ants
-    if (colony->total_ants >= MAX_ANTS_PER_COLONY) {
+    if (colony->ants.count >= world->ant_capacity) {
         print_warning("Colony %d at maximum ant capacity", colony_id);
         return;
     }
     
     // Create ant at nest position
-    Ant* ant = create_ant(colony->total_ants + 1, colony_id, colony->nest_pos);
-    if (ant != NULL) {
-        add_ant_to_colony(colony, ant);
+    int index = add_ant(colony, colony->nest_pos);
+    if (index >= 0) {
+        trace_spawns(world, colony, index, index + 1);
+    }
+}
+
+int spawn_ants(World* world, int colony_id, int count) {
+    if (world == NULL || colony_id < 0 || colony_id >= world->colony_count || count <= 0) {
+        return 0;
+    }
+    
+    Colony* colony = &world->colonies[colony_id];
+    AntStore* ants = &colony->ants;
+    
+    int room = world->ant_capacity - ants->count;
+    if (count > room) {
+        print_warning("Colony %d has room for %d of %d ants", colony_id, (room > 0) ? room : 0, count);
+        count = room;
+        if (count <= 0) return 0;
+    }
+    
+    // One allocation sized for the whole batch
+    if (!reserve_ants(ants, ants->count + count)) {
+        print_error("Failed to allocate %d ants for colony %d", count, colony_id);
+        return 0;
     }
+    
+    int first = ants->count;
+    fill_ants(colony, colony->nest_pos, count);
+    trace_spawns(world, colony, first, ants->count);
+    print_info("Colony %d: %d ants spawned", colony_id, count);
+    return count;
 }
 
 void cleanup_dead_ants(Colony* colony) {
     if (colony == NULL) return;
     
-    Ant** current = &colony->ants_head;
     int removed_count = 0;
     
-    while (*current != NULL) {
-        if ((*current)->state & ANT_STATE_DEAD) {
-            Ant* dead = *current;
-            *current = (*current)->next;
-            
-            // Update colony statistics
-            colony->total_ants--;
-            colony->active_ants--;
-            
-            // Destroy the dead ant
-            destroy_ant(dead);
+    // Swap-remove keeps the store dense; the ant moved into a freed slot
+    // is checked before moving on
+    int index = 0;
+    while (index < colony->ants.count) {
+        if (colony->ants.state[index] & ANT_STATE_DEAD) {
+            remove_ant(colony, index);
             removed_count++;
         } else {
-            current = &(*current)->next;
+            index++;
         }
     }
     
@@ -342,21 +783,97 @@ void cleanup_dead_ants(Colony* colony) {
     }
 }
 
+// Grow the step buffers to the store's capacity; their contents do not
+// survive between steps
+static int reserve_step_buffers(AntStepBuffers* buffers, int capacity) {
+    if (capacity <= buffers->capacity) return 1;
+    
+    int chunks = (capacity + ANT_UPDATE_CHUNK - 1) / ANT_UPDATE_CHUNK;
+    size_t event_bytes = ANT_ARRAY_BYTES(capacity, AntEvent);
+    char* block = (char*)safe_aligned_calloc(1, event_bytes + ANT_ARRAY_BYTES(chunks, int), GRID_ALIGNMENT);
+    if (block == NULL) return 0;
+    
+    safe_aligned_free(buffers->block);
+    buffers->block = block;
+    buffers->events = (AntEvent*)block;
+    buffers->chunk_events = (int*)(block + event_bytes);
+    buffers->capacity = capacity;
+    return 1;
+}
+
+static int ant_chunk_count(const Colony* colony) {
+    return (colony->ants.count + ANT_UPDATE_CHUNK - 1) / ANT_UPDATE_CHUNK;
+}
+
+// Phase one for one chunk of ants; chunks are numbered through the
+// colonies in order
+static void plan_chunk(void* context, int chunk, int chunk_count) {
+    World* world = (World*)context;
+    (void)chunk_count;
+    
+    Colony* colony = world->colonies;
+    while (chunk >= ant_chunk_count(colony)) {
+        chunk -= ant_chunk_count(colony);
+        colony++;
+    }
+    
+    AntStepBuffers* buffers = &colony->step_buffers;
+    int first = chunk * ANT_UPDATE_CHUNK;
+    int end = (first + ANT_UPDATE_CHUNK < colony->ants.count) ? first + ANT_UPDATE_CHUNK : colony->ants.count;
+    
+    // Draws are keyed by ant id and step, not by position in the store
+    uint32_t draws[ANT_UPDATE_CHUNK * ANT_STEP_DRAWS];
+    fill_keyed_random_draws(draws, ANT_STEP_DRAWS, colony->ants.id + first, end - first,
+                            (uint32_t)colony->id, (uint32_t)world->current_step);
+    
+    buffers->chunk_events[chunk] = plan_ants(world, colony, first, end, draws, buffers->events + first);
+}
+
+// Two-phase step. Ants are planned in parallel against the world as it was
+// at the start of the step, so an ant no longer sees deposits made by ants
+// updated before it in the same step. Their records are then applied
+// serially in ant order. Random draws are keyed by ant id and step, so the
+// outcome, including which ant gets contended food, does not depend on
+// the thread count.
 void update_all_ants(World* world) {
     if (world == NULL) return;
     
+    int resort = world->ant_sort_interval > 0 && world->current_step % world->ant_sort_interval == 0;
+    
+    int chunk_count = 0;
+    for (int i = 0; i < world->colony_count; i++) {
+        Colony* colony = &world->colonies[i];
+        AntStore* ants = &colony->ants;
+        
+        if (resort) {
+            sort_ants_by_position(colony);
+        }
+        if (!reserve_step_buffers(&colony->step_buffers, ants->capacity)) {
+            print_error("Failed to allocate ant step buffers for colony %d", colony->id);
+            return;
+        }
+        // Planned moves record positions, and rings cannot be taken from
+        // the colony's pool in parallel
+        if (!reserve_path_histories(colony)) {
+            print_warning("Out of memory for path history, disabling it for colony %d", colony->id);
+            set_path_history_length(colony, 0);
+        }
+        
+        chunk_count += ant_chunk_count(colony);
+    }
+    
+    run_parallel(plan_chunk, world, chunk_count);
+    
     for (int i = 0; i < world->colony_count; i++) {
         Colony* colony = &world->colonies[i];
-        Ant* current = colony->ants_head;
+        const AntStepBuffers* buffers = &colony->step_buffers;
         
-        while (current != NULL) {
-            Ant* next = current->next;  // Store next before updating
-            
-            if (!(current->state & ANT_STATE_DEAD)) {
-                update_ant(world, current);
+        // No ant is added or removed until the cleanup below
+        for (int chunk = 0; chunk < ant_chunk_count(colony); chunk++) {
+            const AntEvent* events = buffers->events + (size_t)chunk * ANT_UPDATE_CHUNK;
+            for (int e = 0; e < buffers->chunk_events[chunk]; e++) {
+                apply_ant_event(world, colony, &events[e]);
             }
-            
-            current = next;
         }
         
         // Clean up dead ants after updating all
@@ -364,27 +881,154 @@ void update_all_ants(World* world) {
     }
 }
 
+// Spatial ordering
+void set_ant_sort_interval(World* world, int interval) {
+    if (world == NULL) return;
+    world->ant_sort_interval = (interval > 0) ? interval : 0;
+}
+
+typedef struct {
+    const AntStore* from;
+    AntStore* to;
+    const uint32_t* order;  // order[i]: old index of the ant that goes to i
+    int count;
+} AntGather;
+
+static void gather_ant_band(void* context, int band, int band_count) {
+    AntGather* gather = (AntGather*)context;
+    const AntStore* from = gather->from;
+    AntStore* to = gather->to;
+    (void)band_count;
+    
+    int first = band * ANT_UPDATE_CHUNK;
+    int end = (first + ANT_UPDATE_CHUNK < gather->count) ? first + ANT_UPDATE_CHUNK : gather->count;
+    for (int index = first; index < end; index++) {
+        uint32_t source = gather->order[index];
+        to->id[index] = from->id[source];
+        to->x[index] = from->x[source];
+        to->y[index] = from->y[source];
+        to->last_x[index] = from->last_x[source];
+        to->last_y[index] = from->last_y[source];
+        to->food_carrying[index] = from->food_carrying[source];
+        to->steps_taken[index] = from->steps_taken[source];
+        to->food_delivered[index] = from->food_delivered[source];
+        to->energy[index] = from->energy[source];
+        to->state[index] = from->state[source];
+        to->path_history[index] = from->path_history[source];
+    }
+}
+
+// Ants on the same cell keep their relative order, so the result only
+// depends on the store. Returns 0 when out of memory, leaving the store
+// as it was.
+int sort_ants_by_position(Colony* colony) {
+    if (colony == NULL) return 0;
+    
+    AntStore* ants = &colony->ants;
+    int count = ants->count;
+    if (count <= 1) return 1;
+    
+    // Keys, the permutation and the sort's scratch space
+    uint32_t* keys = (uint32_t*)safe_malloc((size_t)count * 4 * sizeof(uint32_t));
+    char* block = (char*)safe_aligned_calloc(1, ant_block_size(ants->capacity), GRID_ALIGNMENT);
+    if (keys == NULL || block == NULL) {
+        print_warning("Out of memory sorting the ants of colony %d", colony->id);
+        safe_free(keys);
+        safe_aligned_free(block);
+        return 0;
+    }
+    uint32_t* order = keys + count;
+    for (int index = 0; index < count; index++) {
+        keys[index] = hilbert_index(ants->x[index], ants->y[index]);
+        order[index] = (uint32_t)index;
+    }
+    radix_sort_pairs(keys, order, order + count, order + 2 * (size_t)count, count);
+    
+    AntStore sorted = *ants;
+    assign_ant_arrays(&sorted, block, ants->capacity);
+    AntGather gather = { ants, &sorted, order, count };
+    run_parallel(gather_ant_band, &gather, (count + ANT_UPDATE_CHUNK - 1) / ANT_UPDATE_CHUNK);
+    rebuild_id_index(&sorted);
+    
+    safe_aligned_free(ants->block);
+    *ants = sorted;
+    safe_free(keys);
+    return 1;
+}
+
 // Path tracking
-void add_path_node(Ant* ant, Position pos, float pheromone) {
-    if (ant == NULL) return;
+#define PACK_PATH_POSITION(x, y) (((uint32_t)(y) << 16) | (uint32_t)(x))
+
+void set_path_history_length(Colony* colony, int length) {
+    if (colony == NULL) return;
+    
+    // Rings are sized for the old length; drop them all
+    release_slab_pool(&colony->path_pool);
+    for (int index = 0; index < colony->ants.count; index++) {
+        colony->ants.path_history[index] = NULL;
+    }
+    
+    colony->path_length = clamp_int(length, 0, MAX_PATH_HISTORY_LENGTH);
+    size_t ring_size = sizeof(PathHistory) + (size_t)colony->path_length * sizeof(uint32_t);
+    init_slab_pool(&colony->path_pool, ring_size, (int)(PATH_SLAB_BYTES / SLAB_OBJECT_SIZE(ring_size)));
+}
+
+// The ant's ring, taken from the pool on first use
+static PathHistory* take_path_history(Colony* colony, int index) {
+    PathHistory* history = colony->ants.path_history[index];
+    if (history == NULL) {
+        history = (PathHistory*)slab_alloc(&colony->path_pool);
+        if (history == NULL) return NULL;
+        history->next = 0;
+        history->count = 0;
+        colony->ants.path_history[index] = history;
+    }
+    return history;
+}
+
+// Give every live ant its ring ahead of a parallel update
+static int reserve_path_histories(Colony* colony) {
+    if (colony->path_length == 0) return 1;
+    
+    for (int index = 0; index < colony->ants.count; index++) {
+        if (!(colony->ants.state[index] & ANT_STATE_DEAD) && take_path_history(colony, index) == NULL) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void record_path_position(Colony* colony, int index, Position pos) {
+    if (colony == NULL || colony->path_length == 0) return;
     
-    PathNode* node = (PathNode*)safe_malloc(sizeof(PathNode));
-    if (node == NULL) return;
+    PathHistory* history = take_path_history(colony, index);
+    if (history == NULL) return;
     
-    node->pos = pos;
-    node->pheromone_strength = pheromone;
-    node->next = ant->path_history;
-    ant->path_history = node;
+    // Overwrite the oldest position once the ring is full
+    history->positions[history->next] = PACK_PATH_POSITION(pos.x, pos.y);
+    if (++history->next == (uint32_t)colony->path_length) history->next = 0;
+    if (history->count < (uint32_t)colony->path_length) history->count++;
 }
 
-void clear_path_history(Ant* ant) {
-    if (ant == NULL) return;
+int get_path_history(const Colony* colony, int index, Position* positions, int max_positions) {
+    if (colony == NULL || positions == NULL) return 0;
     
-    PathNode* current = ant->path_history;
-    while (current != NULL) {
-        PathNode* next = current->next;
-        safe_free(current);
-        current = next;
+    const PathHistory* history = colony->ants.path_history[index];
+    if (history == NULL) return 0;
+    
+    int count = ((int)history->count < max_positions) ? (int)history->count : max_positions;
+    uint32_t slot = history->next;
+    for (int i = 0; i < count; i++) {
+        slot = (slot == 0) ? (uint32_t)colony->path_length - 1 : slot - 1;
+        positions[i].x = (int)(history->positions[slot] & 0xFFFF);
+        positions[i].y = (int)(history->positions[slot] >> 16);
     }
-    ant->path_history = NULL;
+    return count;
+}
+
+void clear_path_history(Colony* colony, int index) {
+    if (colony == NULL) return;
+    
+    slab_free(&colony->path_pool, colony->ants.path_history[index]);
+    colony->ants.path_history[index] = NULL;
 }
@@ -3,37 +3,57 @@
 
 #include "data_structures.h"
 
-// Ant creation and management
-Ant* create_ant(int id, int colony_id, Position pos);
-void destroy_ant(Ant* ant);
-void add_ant_to_colony(Colony* colony, Ant* ant);
-void remove_ant_from_colony(Colony* colony, Ant* ant);
+// Ant store (structure of arrays, one per colony)
+int reserve_ants(AntStore* store, int capacity);
+void release_colony_ants(Colony* colony);  // Drops every ant and its path history
+
+// Ant creation and management; functions below address an ant by its
+// index in colony->ants
+int add_ant(Colony* colony, Position pos);  // Index of the new ant, -1 on failure
+int restore_ant(Colony* colony, const Ant* ant);  // Re-add a saved ant, keeping its id
+void remove_ant(Colony* colony, int index);  // The last ant moves into index
+void get_ant(const Colony* colony, int index, Ant* ant);
+int find_ant_by_id(const Colony* colony, int id);  // Index of the ant, -1 if none; constant time
 
 // Ant movement
-void move_ant(Ant* ant, World* world, int direction);
-void move_randomly(Ant* ant, World* world);
-void follow_pheromone_gradient(Ant* ant, World* world, int pheromone_type);
+void move_ant(World* world, Colony* colony, int index, int direction);
+void move_randomly(World* world, Colony* colony, int index);
+void follow_pheromone_gradient(World* world, Colony* colony, int index, int pheromone_type);
 
 // Ant behavior
-void update_ant(World* world, Ant* ant);
-void decide_direction(Ant* ant, World* world);
-void handle_food_interaction(Ant* ant, World* world);
-void handle_nest_return(Ant* ant, World* world);
+void update_ant(World* world, Colony* colony, int index);
+void decide_direction(World* world, Colony* colony, int index);
+void handle_food_interaction(World* world, Colony* colony, int index);
+void handle_nest_return(World* world, Colony* colony, int index);
 
 // Ant state management
-void set_ant_state(Ant* ant, uint8_t state);
-void clear_ant_state(Ant* ant, uint8_t state);
-int has_ant_state(const Ant* ant, uint8_t state);
-void toggle_ant_state(Ant* ant, uint8_t state);
+void set_ant_state(Colony* colony, int index, uint8_t state);
+void clear_ant_state(Colony* colony, int index, uint8_t state);
+int has_ant_state(const Colony* colony, int index, uint8_t state);
+void toggle_ant_state(Colony* colony, int index, uint8_t state);
 
 // Colony ant management
+void set_ant_population(World* world, int initial_ants, int capacity);
 void spawn_ant(World* world, int colony_id);
+int spawn_ants(World* world, int colony_id, int count);  // Number actually spawned
 void cleanup_dead_ants(Colony* colony);
 void update_all_ants(World* world);
 
-// Path tracking
-void add_path_node(Ant* ant, Position pos, float pheromone);
-void clear_path_history(Ant* ant);
+// Spatial ordering: sort_ants_by_position reorders the colony's store along
+// a Hilbert curve over the ants' cells, so ants next to each other in
+// memory read neighbouring cells; update_all_ants does it for every colony
+// each ant_sort_interval steps. Ant indices change, ids do not.
+void set_ant_sort_interval(World* world, int interval);
+int sort_ants_by_position(Colony* colony);
+
+// Path tracking: each ant keeps its colony's path_length most recent
+// positions. get_path_history copies up to max_positions of them, newest
+// first, and returns the number copied. Changing the length discards every
+// recorded history.
+void set_path_history_length(Colony* colony, int length);
+void record_path_position(Colony* colony, int index, Position pos);
+int get_path_history(const Colony* colony, int index, Position* positions, int max_positions);
+void clear_path_history(Colony* colony, int index);
 
 // Direction arrays (extern declarations)
 extern const int dx[8];
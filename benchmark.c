@@ -0,0 +1,149 @@
+#include "benchmark.h"
+#include "config.h"
+#include "world.h"
+#include "ant_logic.h"
+#include "pheromones.h"
+#include "thread_pool.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CACHE_SETS (BENCHMARK_CACHE_BYTES / (BENCHMARK_CACHE_LINE * BENCHMARK_CACHE_WAYS))
+
+// Set-associative LRU cache over line numbers. Hardware counters are not
+// portable, so misses are counted on a model of the access stream instead.
+typedef struct {
+    uint64_t tags[CACHE_SETS][BENCHMARK_CACHE_WAYS];
+    uint64_t used[CACHE_SETS][BENCHMARK_CACHE_WAYS];  // Access clock of each way, 0 = empty
+    uint64_t clock;
+    uint64_t misses;
+} CacheModel;
+
+static void access_line(CacheModel* cache, uint64_t line) {
+    uint64_t* tags = cache->tags[line % CACHE_SETS];
+    uint64_t* used = cache->used[line % CACHE_SETS];
+    int victim = 0;
+
+    cache->clock++;
+    for (int way = 0; way < BENCHMARK_CACHE_WAYS; way++) {
+        if (used[way] != 0 && tags[way] == line) {
+            used[way] = cache->clock;
+            return;
+        }
+        if (used[way] < used[victim]) {
+            victim = way;
+        }
+    }
+    tags[victim] = line;
+    used[victim] = cache->clock;
+    cache->misses++;
+}
+
+// Feed the cache the pheromone lines each ant senses, the 3x3 cells around
+// it in its colony's channel, in store order. Addresses follow the tile
+// layout as if every tile were allocated back to back.
+static void model_ant_reads(const World* world, CacheModel* cache) {
+    for (int c = 0; c < world->colony_count; c++) {
+        const AntStore* ants = &world->colonies[c].ants;
+        uint64_t channel = (uint64_t)PHEROMONE_CHANNEL(c, PHEROMONE_TYPE_FOOD);
+
+        for (int index = 0; index < ants->count; index++) {
+            for (int d = -1; d <= 1; d++) {
+                int y = ants->y[index] + d;
+                if (y < 0 || y >= world->height) continue;
+                for (int e = -1; e <= 1; e++) {
+                    int x = ants->x[index] + e;
+                    if (x < 0 || x >= world->width) continue;
+
+                    uint64_t tile = (uint64_t)(y >> WORLD_TILE_SHIFT) * world->tiles_x + (x >> WORLD_TILE_SHIFT);
+                    uint64_t cell = ((uint64_t)(y & WORLD_TILE_MASK) << WORLD_TILE_SHIFT) | (x & WORLD_TILE_MASK);
+                    uint64_t level = (tile * world->pheromone_channels + channel) * WORLD_TILE_CELLS + cell;
+                    access_line(cache, level * sizeof(PheromoneLevel) / BENCHMARK_CACHE_LINE);
+                }
+            }
+        }
+    }
+}
+
+typedef struct {
+    double ns_per_ant_step;
+    double misses_per_ant_step;
+} BenchmarkResult;
+
+static int run_benchmark_pass(int sort_interval, CacheModel* cache, BenchmarkResult* result) {
+    set_random_seed(BENCHMARK_SEED);
+    init_random();
+
+    World* world = create_world(BENCHMARK_WORLD_SIZE, BENCHMARK_WORLD_SIZE, BENCHMARK_COLONIES);
+    if (world == NULL) return 0;
+    for (int c = 0; c < world->colony_count; c++) {
+        place_colony(world, c, (2 * c + 1) * world->width / (2 * world->colony_count), world->height / 2);
+    }
+    set_ant_population(world, BENCHMARK_ANTS_PER_COLONY, BENCHMARK_ANTS_PER_COLONY);
+    set_ant_sort_interval(world, sort_interval);
+    spawn_initial_ants(world);
+
+    // Spread the ants out, so spawn order says nothing about position
+    for (int c = 0; c < world->colony_count; c++) {
+        AntStore* ants = &world->colonies[c].ants;
+        for (int index = 0; index < ants->count; index++) {
+            ants->x[index] = ants->last_x[index] = random_int(0, world->width - 1);
+            ants->y[index] = ants->last_y[index] = random_int(0, world->height - 1);
+        }
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    uint64_t ant_steps = 0;
+    uint64_t elapsed_ms = 0;
+    for (int step = 0; step < BENCHMARK_STEPS; step++) {
+        for (int c = 0; c < world->colony_count; c++) {
+            ant_steps += (uint64_t)world->colonies[c].ants.count;
+        }
+
+        uint64_t start = get_time_ms();
+        update_all_ants(world);
+        elapsed_ms += get_time_ms() - start;
+
+        // The order this step ran in, at the ants' new cells
+        model_ant_reads(world, cache);
+        queue_pheromone_step(world);
+        world->current_step++;
+    }
+    flush_pheromone_steps(world);
+    destroy_world(world);
+
+    if (ant_steps == 0) return 0;
+    result->ns_per_ant_step = (double)elapsed_ms * 1e6 / (double)ant_steps;
+    result->misses_per_ant_step = (double)cache->misses / (double)ant_steps;
+    return 1;
+}
+
+int run_ant_benchmark(void) {
+    // Too large for the stack
+    CacheModel* cache = (CacheModel*)safe_malloc(sizeof(CacheModel));
+    if (cache == NULL) return 1;
+
+    BenchmarkResult unsorted, sorted;
+    int ok = run_benchmark_pass(0, cache, &unsorted) &&
+             run_benchmark_pass(BENCHMARK_SORT_INTERVAL, cache, &sorted);
+    safe_free(cache);
+    if (!ok) {
+        print_error("Benchmark failed to set up its world");
+        return 1;
+    }
+
+    printf("\nAnt locality benchmark: %d colonies x %d ants, %dx%d world, %d steps, %d threads\n",
+           BENCHMARK_COLONIES, BENCHMARK_ANTS_PER_COLONY, BENCHMARK_WORLD_SIZE, BENCHMARK_WORLD_SIZE,
+           BENCHMARK_STEPS, get_thread_count());
+    printf("Modeled cache: %d KB, %d-way, %d-byte lines\n\n", BENCHMARK_CACHE_BYTES / 1024,
+           BENCHMARK_CACHE_WAYS, BENCHMARK_CACHE_LINE);
+    printf("%-28s %14s %18s\n", "Order", "ns / ant step", "misses / ant step");
+    printf("%-28s %14.1f %18.2f\n", "spawn order", unsorted.ns_per_ant_step, unsorted.misses_per_ant_step);
+    printf("Hilbert, every %-3d steps     %14.1f %18.2f\n", BENCHMARK_SORT_INTERVAL,
+           sorted.ns_per_ant_step, sorted.misses_per_ant_step);
+    if (unsorted.misses_per_ant_step > 0) {
+        printf("\nModeled misses reduced by %.1f%%\n",
+               100.0 * (1.0 - sorted.misses_per_ant_step / unsorted.misses_per_ant_step));
+    }
+    return 0;
+}
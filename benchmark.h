@@ -0,0 +1,12 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Ant locality benchmark. Scatters BENCHMARK_ANTS_PER_COLONY ants per
+// colony over a large world and steps them twice from the same seed, once
+// in spawn order and once re-sorted along a Hilbert curve every
+// BENCHMARK_SORT_INTERVAL steps, reporting the ant step time and the
+// misses a modeled L1 cache takes on the pheromone cells the ants sense.
+// Returns 0 on success.
+int run_ant_benchmark(void);
+
+#endif // BENCHMARK_H
@@ -26,6 +26,12 @@ cl /Fe:bin\AntColonySimulator.exe ^
    src\file_io.c ^
    src\algorithms.c ^
    src\utils.c ^
+   src\pheromone_kernels.c ^
+   src\ant_kernels.c ^
+   src\thread_pool.c ^
+   src\slab_pool.c ^
+   src\trace_log.c ^
+   src\benchmark.c ^
    /I:src ^
    /std:c11 ^
    /link user32.lib ^
@@ -33,9 +39,14 @@ cl /Fe:bin\AntColonySimulator.exe ^
    /D_DEBUG ^
    /Zi
 
+if %errorlevel% equ 0 (
+    echo Compiling trace decoder...
+    cl /Fe:bin\trace_decode.exe tools\trace_decode.c /I:src /std:c11 /W3
+)
+
 if %errorlevel% equ 0 (
     echo.
-    echo Build successful! Executable created: bin\AntColonySimulator.exe
+    echo Build successful! Executables created: bin\AntColonySimulator.exe, bin\trace_decode.exe
 ) else (
     echo.
     echo Build failed! Please check the error messages above.
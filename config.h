@@ -7,14 +7,55 @@
 // World parameters
 #define DEFAULT_WORLD_WIDTH 60
 #define DEFAULT_WORLD_HEIGHT 30
-#define MAX_WORLD_SIZE 100
+#define MAX_WORLD_SIZE 65536
+
+// Memory layout
+#define GRID_ALIGNMENT 64  // Cache-line alignment for world grid planes
+#define WORLD_TILE_SHIFT 6  // Worlds are stored as 64x64 cell tiles
+#define WORLD_TILE_SIZE (1 << WORLD_TILE_SHIFT)
+#define WORLD_TILE_MASK (WORLD_TILE_SIZE - 1)
+#define WORLD_TILE_CELLS (WORLD_TILE_SIZE * WORLD_TILE_SIZE)
+
+// Logging. Messages above LOG_COMPILE_LEVEL are compiled out; debug builds
+// keep everything, release builds stop at info. Build with e.g.
+// LOG_COMPILE_LEVEL=4 to keep per-ant trace messages in a release build.
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARNING 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3    // Per-ant events: spawns, pickups, deliveries, deaths
+#define LOG_LEVEL_TRACE 4    // Per-ant, per-step messages: moves, trail following, deposits
+#ifndef LOG_COMPILE_LEVEL
+    #ifdef _DEBUG
+        #define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+    #else
+        #define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+    #endif
+#endif
+#define DEFAULT_LOG_LEVEL LOG_LEVEL_INFO  // Runtime filter (override with --log-level)
+#define TRACE_RING_RECORDS 16384  // Binary trace records buffered per thread (power of two)
+#define TRACE_DRAIN_INTERVAL_MS 2  // Trace writer's sleep when every ring is empty
+
+// Threading
+#define DEFAULT_THREAD_COUNT 1  // Override with --threads N (0 = all cores)
+#define MAX_THREAD_COUNT 64
+#define BANDS_PER_THREAD 4  // Row bands per worker for load balancing
 
 // Ant parameters
-#define INITIAL_ANTS_PER_COLONY 20
-#define MAX_ANTS_PER_COLONY 50
+#define INITIAL_ANTS_PER_COLONY 20  // Override with --ants N
+#define DEFAULT_ANTS_PER_COLONY 50  // Colony capacity (override with --max-ants N)
+#define MAX_ANTS_PER_COLONY (1 << 24)  // Largest capacity --max-ants accepts
 #define ANT_INITIAL_ENERGY 1000
 #define ANT_ENERGY_PER_STEP 1
 #define ANT_ENERGY_FROM_FOOD 500
+#define ANT_TIRED_ENERGY (ANT_INITIAL_ENERGY * 0.2f)  // Ants below this are flagged tired
+#define PATH_HISTORY_LENGTH 32  // Recent positions kept per ant (override with --path-length N, 0 = off)
+#define MAX_PATH_HISTORY_LENGTH 4096
+#define PATH_SLAB_BYTES 65536  // Target size of a path history slab
+#define ANT_UPDATE_CHUNK 1024  // Ants per work item of the parallel ant update
+#define ANT_KERNEL_BATCH 64  // Ants per decision kernel call
+#define ANT_KERNEL_CHECK_ROUNDS 10000  // Random batches per kernel in --test-suite
+#define DEFAULT_ANT_SORT_INTERVAL 0  // Steps between spatial re-sorts of each colony's ants (override with --sort-interval N, 0 = off)
+#define RADIX_SORT_MIN_BAND 16384  // Fewest keys per parallel radix sort band
 
 // Pheromone parameters
 #define PHEROMONE_INITIAL 0.0f
@@ -22,13 +63,32 @@
 #define PHEROMONE_DEPOSIT_AMOUNT 100.0f
 #define PHEROMONE_EVAPORATION_RATE 0.02f
 #define PHEROMONE_DIFFUSION_RATE 0.01f
+#define PHEROMONE_CUTOFF 0.1f  // Levels below this evaporate completely
+#define LAZY_DECAY_TABLE_SIZE 512  // Covers PHEROMONE_MAX decaying below the cut-off
+#define PHEROMONE_BLOCK_STEPS 1  // Field steps per blocked sweep (override with --block-steps)
+#define MAX_PHEROMONE_BLOCK_STEPS 8  // Also the halo width of a block's tile window
+#define PHEROMONE_KERNEL_CHECK_ROUNDS 10000  // Random rows per kernel in --test-suite
+#define PHEROMONE_DECAY_CHECK_STEPS 2000  // Steps --test-suite allows an untouched field to fade
+#define GRADIENT_NONE 8  // Direction plane entry: no walkable neighbour holds pheromone
+#define GRADIENT_STALE 0xFF  // Direction plane entry: changed since the plane was built
+
+// Pheromone storage: 32-bit float by default; build with PHEROMONE_FIXED16=1
+// to store levels as 16-bit fixed point and halve the field's memory
+#ifndef PHEROMONE_FIXED16
+    #define PHEROMONE_FIXED16 0
+#endif
+#define PHEROMONE_FIXED_SCALE 64.0f  // Fixed-point steps per unit (PHEROMONE_MAX * 64 < 65536)
 
 // Pheromone types
 #define PHEROMONE_FOOD 0
 #define PHEROMONE_HOME 1
+#define PHEROMONE_TYPE_COUNT 2
 
 // Terrain constants
 #define TERRAIN_OBSTACLE 2  // Obstacle terrain type
+#define RANDOM_OBSTACLE_DENSITY 20  // Random worlds: one obstacle per this many cells...
+#define RANDOM_OBSTACLE_LIMIT 2048  // ...up to this many, so large worlds allocate few tiles
+#define RANDOM_OBSTACLE_CLUSTER 8  // Obstacles per random-walk cluster
 
 // Behavior parameters
 #define FOLLOW_PHEROMONE_PROBABILITY 0.8f
@@ -74,4 +134,15 @@
 #define RENDER_DELAY_MS 100
 #define MAX_SIMULATION_STEPS 10000
 
+// Ant locality benchmark (--benchmark)
+#define BENCHMARK_WORLD_SIZE 2048
+#define BENCHMARK_COLONIES 2
+#define BENCHMARK_ANTS_PER_COLONY 250000
+#define BENCHMARK_STEPS 50
+#define BENCHMARK_SORT_INTERVAL 10
+#define BENCHMARK_SEED 12345
+#define BENCHMARK_CACHE_BYTES 32768  // Modeled L1 data cache
+#define BENCHMARK_CACHE_WAYS 8
+#define BENCHMARK_CACHE_LINE 64
+
 #endif // CONFIG_H
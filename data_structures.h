@@ -1,7 +1,9 @@
 #ifndef DATA_STRUCTURES_H
 #define DATA_STRUCTURES_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include "config.h"
 
 // Forward declarations
 typedef struct Ant Ant;
@@ -23,44 +25,129 @@ typedef enum {
     TERRAIN_WATER
 } TerrainType;
 
-// Cell struct for world grid
+// Cell snapshot assembled from the world planes by get_cell()
 typedef struct {
     TerrainType terrain;
-    float pheromone_food;
+    float pheromone_food;  // Strongest trail of any colony
     float pheromone_home;
     int food_amount;
     int colony_id;  // For nests
-    int has_colony;  // Boolean flag for colony presence
-    int has_food;    // Boolean flag for food presence
 } Cell;
 
-// Path node for tracking ant movement history
-typedef struct PathNode {
-    Position pos;  // Keep as pos to match usage in code
-    Position position;  // Add alias for compatibility with existing code
-    float pheromone_strength;
-    struct PathNode* next;
-} PathNode;
+// Stored pheromone level: float, or 16-bit fixed point in PHEROMONE_FIXED16
+// builds. Always convert through these macros. Narrowing truncates:
+// rounding to nearest would stop decay in the low range, where
+// round(0.98 * n) == n for every n <= 25 steps.
+#if PHEROMONE_FIXED16
+typedef uint16_t PheromoneLevel;
+#define PHEROMONE_LEVEL_TO_FLOAT(level) ((float)(level) * (1.0f / PHEROMONE_FIXED_SCALE))
+#define PHEROMONE_LEVEL_FROM_FLOAT(value) ((PheromoneLevel)((value) * PHEROMONE_FIXED_SCALE))
+#else
+typedef float PheromoneLevel;
+#define PHEROMONE_LEVEL_TO_FLOAT(level) (level)
+#define PHEROMONE_LEVEL_FROM_FLOAT(value) (value)
+#endif
 
-// Ant struct with linked list support
+// World tile: a WORLD_TILE_SIZE x WORLD_TILE_SIZE block of cells stored as
+// structure-of-arrays planes. Tiles are only allocated once a cell in them
+// is given non-default content.
+typedef struct {
+    int food_amount[WORLD_TILE_CELLS];
+    int16_t colony_id[WORLD_TILE_CELLS];  // Owning colony for nests, -1 elsewhere
+    uint8_t terrain[WORLD_TILE_CELLS];    // TerrainType values
+    uint8_t walk_mask[WORLD_TILE_CELLS];  // Bit d set if the neighbour in direction d (dx/dy) is walkable
+    // Double-buffered pheromone planes. Each buffer holds one plane of
+    // WORLD_TILE_CELLS levels per channel, colony-major (PHEROMONE_CHANNEL),
+    // and lives in the same allocation as the tile. The front buffer holds
+    // current levels; diffusion writes the back buffer and then flips front.
+    PheromoneLevel* pheromone[2];
+    uint8_t front;                        // Index of the current pheromone buffer
+    uint32_t decay_stamp;                 // Lazy evaporation: clock the levels were last decayed to
+    // Best-direction planes, one byte per cell and channel (see
+    // get_pheromone_gradient); current while gradient_stamp matches
+    // World.pheromone_version
+    uint8_t* gradient;
+    uint32_t gradient_stamp;
+} WorldTile;
+
+// Ring buffer of an ant's most recent positions, allocated from its
+// colony's path pool with room for Colony.path_length entries. Positions
+// are packed as y << 16 | x (world sides are at most 65536 cells).
+typedef struct PathHistory {
+    uint32_t next;   // Slot the next position is written to
+    uint32_t count;  // Positions recorded, at most the ring length
+    uint32_t positions[];
+} PathHistory;
+
+// Fixed-size object pool (see slab_pool.h). Objects are carved from
+// cache-line aligned slabs in whole cache lines and recycled through a
+// free list threaded through the free objects themselves.
+typedef struct {
+    size_t object_size;  // Rounded up to whole cache lines
+    int objects_per_slab;
+    void* slabs;      // Most recent slab; each slab links to the previous one
+    void* free_list;
+    int slab_count;
+    int in_use;       // Objects currently allocated
+    int peak_in_use;
+} SlabPool;
+
+// Ant snapshot assembled from a colony's ant store by get_ant()
 typedef struct Ant {
     int id;
-    Position pos;  // Changed back to pos to match existing code usage
+    Position pos;
     Position last_pos;
-    Position position;  // Add alias for compatibility with existing code
     uint8_t state;  // Bitwise flags for states
     int colony_id;
     float energy;
     int food_carrying;
     int steps_taken;
     int food_delivered;
-    int food_collected; // Added to match usage in tests
-    float pheromone_strength;
-    float exploration_rate;
-    struct Ant* next;  // Linked list pointer
-    PathNode* path_history;
 } Ant;
 
+// Structure-of-arrays ant store, one per colony. Ant i is element i of
+// every array. Removing an ant moves the last one into its slot, so
+// indices only hold between removals; ids are unique within the colony and
+// stay with the ant for its whole life.
+typedef struct {
+    int count;
+    int capacity;
+    int last_id;  // Highest id handed out so far
+    int32_t* id;
+    int32_t* x;
+    int32_t* y;
+    int32_t* last_x;
+    int32_t* last_y;
+    uint8_t* state;  // ANT_STATE_* flags
+    float* energy;
+    int32_t* food_carrying;
+    int32_t* steps_taken;
+    int32_t* food_delivered;
+    PathHistory** path_history;  // NULL until the ant first moves
+    int32_t* id_index;  // Open-addressing table of slots by id, -1 = empty (see find_ant_by_id)
+    int id_index_bits;  // The table has 1 << id_index_bits entries
+    void* block;  // One allocation holding every array
+} AntStore;
+
+// Effects of one ant's update on shared state, recorded by phase one of the
+// ant step and applied in ant order by phase two (see update_all_ants)
+typedef struct {
+    int32_t index;      // Ant in the colony's store
+    int32_t food_x;     // Cell the ant found food on
+    int32_t food_y;
+    int32_t delivered;  // Food handed over at the nest
+    uint8_t flags;      // ANT_EVENT_* in ant_logic.c
+} AntEvent;
+
+// Scratch space of the ant step, sized for the colony's ant store and kept
+// between steps
+typedef struct {
+    int capacity;
+    AntEvent* events;   // Phase one's records, one slot per ant
+    int* chunk_events;  // Records made by each chunk of ANT_UPDATE_CHUNK ants
+    void* block;
+} AntStepBuffers;
+
 // Colony struct
 typedef struct Colony {
     int id;
@@ -69,9 +156,10 @@ typedef struct Colony {
     int food_collected;
     int total_ants;
     int active_ants;
-    Ant* ants_head;  // Keep as ants_head to match usage
-    Ant* ants;      // Also add ants alias for some code that expects it
-    int ant_count;  // Current ant count
+    AntStore ants;
+    int path_length;  // Positions each ant's path history keeps, 0 = none
+    SlabPool path_pool;  // PathHistory rings of every ant in the colony
+    AntStepBuffers step_buffers;
     float efficiency_score;
     int color;  // For visualization
     int total_food_collected;  // Total food collected over time
@@ -85,7 +173,34 @@ typedef struct Colony {
 typedef struct World {
     int width;
     int height;
-    Cell** grid;  // Dynamic 2D array
+    // Tiled grid: tiles_x * tiles_y tile pointers in row-major order,
+    // NULL for regions that have never been written
+    int tiles_x;
+    int tiles_y;
+    WorldTile** tiles;
+    int allocated_tiles;
+    int pheromone_channels;  // colony_count * PHEROMONE_TYPE_COUNT
+    // One bit per tile, set while the tile may hold pheromone. Each tile row
+    // is padded to whole words so parallel bands never share a word.
+    uint64_t* active_tiles;
+    int active_row_words;
+    // Lazy evaporation: evaporate_pheromones only advances pheromone_clock
+    // and tiles are decayed to the clock when next read or written
+    int lazy_evaporation;
+    uint32_t pheromone_clock;
+    // Temporal blocking: field steps are queued and advanced
+    // pheromone_block_steps at a time, one tile visit per block
+    int pheromone_block_steps;
+    int pheromone_pending_steps;
+    // Precomputed gradient directions, rebuilt for active tiles after every
+    // field pass. pheromone_version counts the passes.
+    int pheromone_gradients;
+    uint32_t pheromone_version;
+    // Ant population: spawn_initial_ants creates initial_ants per colony and
+    // no colony grows past ant_capacity live ants
+    int initial_ants;
+    int ant_capacity;
+    int ant_sort_interval;  // Steps between spatial re-sorts of the ant stores, 0 = never
     Colony* colonies;
     int colony_count;
     int current_step;
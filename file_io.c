@@ -1,6 +1,8 @@
 #include "file_io.h"
 #include "utils.h"
 #include "world.h"
+#include "pheromones.h"
+#include "ant_logic.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -56,14 +58,30 @@ int save_simulation(const World* world, const char* filename) {
     }
     
     // Write grid data
+    Cell cell;
     for (int y = 0; y < world->height; y++) {
         for (int x = 0; x < world->width; x++) {
-            Cell* cell = &world->grid[y][x];
-            if (fwrite(&cell->terrain, sizeof(TerrainType), 1, file) != 1 ||
-                fwrite(&cell->pheromone_food, sizeof(float), 1, file) != 1 ||
-                fwrite(&cell->pheromone_home, sizeof(float), 1, file) != 1 ||
-                fwrite(&cell->food_amount, sizeof(int), 1, file) != 1 ||
-                fwrite(&cell->colony_id, sizeof(int), 1, file) != 1) {
+            get_cell(world, x, y, &cell);
+            if (fwrite(&cell.terrain, sizeof(TerrainType), 1, file) != 1) {
+                print_error("Failed to write grid data");
+                fclose(file);
+                return FILE_IO_ERROR_WRITE;
+            }
+            
+            // Food and home level of every colony's trail
+            for (int i = 0; i < world->colony_count; i++) {
+                float food = get_pheromone_intensity(world, x, y, i, PHEROMONE_TYPE_FOOD);
+                float home = get_pheromone_intensity(world, x, y, i, PHEROMONE_TYPE_HOME);
+                if (fwrite(&food, sizeof(float), 1, file) != 1 ||
+                    fwrite(&home, sizeof(float), 1, file) != 1) {
+                    print_error("Failed to write grid data");
+                    fclose(file);
+                    return FILE_IO_ERROR_WRITE;
+                }
+            }
+            
+            if (fwrite(&cell.food_amount, sizeof(int), 1, file) != 1 ||
+                fwrite(&cell.colony_id, sizeof(int), 1, file) != 1) {
                 print_error("Failed to write grid data");
                 fclose(file);
                 return FILE_IO_ERROR_WRITE;
@@ -73,24 +91,24 @@ int save_simulation(const World* world, const char* filename) {
     
     // Write ants data
     for (int i = 0; i < world->colony_count; i++) {
-        Colony* colony = &world->colonies[i];
-        Ant* current = colony->ants_head;
+        const Colony* colony = &world->colonies[i];
         
-        while (current != NULL) {
-            if (fwrite(&current->id, sizeof(int), 1, file) != 1 ||
-                fwrite(&current->pos, sizeof(Position), 1, file) != 1 ||
-                fwrite(&current->last_pos, sizeof(Position), 1, file) != 1 ||
-                fwrite(&current->state, sizeof(uint8_t), 1, file) != 1 ||
-                fwrite(&current->colony_id, sizeof(int), 1, file) != 1 ||
-                fwrite(&current->energy, sizeof(float), 1, file) != 1 ||
-                fwrite(&current->food_carrying, sizeof(int), 1, file) != 1 ||
-                fwrite(&current->steps_taken, sizeof(int), 1, file) != 1 ||
-                fwrite(&current->food_delivered, sizeof(int), 1, file) != 1) {
+        for (int index = 0; index < colony->ants.count; index++) {
+            Ant ant;
+            get_ant(colony, index, &ant);
+            if (fwrite(&ant.id, sizeof(int), 1, file) != 1 ||
+                fwrite(&ant.pos, sizeof(Position), 1, file) != 1 ||
+                fwrite(&ant.last_pos, sizeof(Position), 1, file) != 1 ||
+                fwrite(&ant.state, sizeof(uint8_t), 1, file) != 1 ||
+                fwrite(&ant.colony_id, sizeof(int), 1, file) != 1 ||
+                fwrite(&ant.energy, sizeof(float), 1, file) != 1 ||
+                fwrite(&ant.food_carrying, sizeof(int), 1, file) != 1 ||
+                fwrite(&ant.steps_taken, sizeof(int), 1, file) != 1 ||
+                fwrite(&ant.food_delivered, sizeof(int), 1, file) != 1) {
                 print_error("Failed to write ant data");
                 fclose(file);
                 return FILE_IO_ERROR_WRITE;
             }
-            current = current->next;
         }
         
         // Write end marker for this colony
@@ -131,12 +149,18 @@ World* load_simulation(const char* filename) {
     }
     
     // Read version
-    char version[16];
+    char version[16] = {0};
     if (fread(version, sizeof(char), strlen(SAVE_FILE_VERSION), file) != strlen(SAVE_FILE_VERSION)) {
         print_error("Failed to read file version");
         fclose(file);
         return NULL;
     }
+    int shared_trails = (strcmp(version, SAVE_FILE_VERSION_SHARED_TRAILS) == 0);
+    if (!shared_trails && strcmp(version, SAVE_FILE_VERSION) != 0) {
+        print_error("Unsupported save file version '%s'", version);
+        fclose(file);
+        return NULL;
+    }
     
     // Read world dimensions
     int width, height, colony_count;
@@ -172,25 +196,48 @@ World* load_simulation(const char* filename) {
         
         // Update grid to reflect colony position
         if (is_valid_position(world, colony->nest_pos.x, colony->nest_pos.y)) {
-            world->grid[colony->nest_pos.y][colony->nest_pos.x].terrain = TERRAIN_NEST;
-            world->grid[colony->nest_pos.y][colony->nest_pos.x].colony_id = i;
+            set_terrain(world, colony->nest_pos.x, colony->nest_pos.y, TERRAIN_NEST);
+            set_nest_colony(world, colony->nest_pos.x, colony->nest_pos.y, i);
         }
     }
     
     // Read grid data
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            Cell* cell = &world->grid[y][x];
-            if (fread(&cell->terrain, sizeof(TerrainType), 1, file) != 1 ||
-                fread(&cell->pheromone_food, sizeof(float), 1, file) != 1 ||
-                fread(&cell->pheromone_home, sizeof(float), 1, file) != 1 ||
-                fread(&cell->food_amount, sizeof(int), 1, file) != 1 ||
-                fread(&cell->colony_id, sizeof(int), 1, file) != 1) {
+            Cell cell;
+            if (fread(&cell.terrain, sizeof(TerrainType), 1, file) != 1) {
                 print_error("Failed to read grid data");
                 fclose(file);
                 destroy_world(world);
                 return NULL;
             }
+            
+            // Version 1.0 files hold one trail pair shared by all colonies
+            for (int i = 0; i < colony_count; i++) {
+                if (i == 0 || !shared_trails) {
+                    if (fread(&cell.pheromone_food, sizeof(float), 1, file) != 1 ||
+                        fread(&cell.pheromone_home, sizeof(float), 1, file) != 1) {
+                        print_error("Failed to read grid data");
+                        fclose(file);
+                        destroy_world(world);
+                        return NULL;
+                    }
+                }
+                set_pheromone_intensity(world, x, y, i, PHEROMONE_TYPE_FOOD, cell.pheromone_food);
+                set_pheromone_intensity(world, x, y, i, PHEROMONE_TYPE_HOME, cell.pheromone_home);
+            }
+            
+            if (fread(&cell.food_amount, sizeof(int), 1, file) != 1 ||
+                fread(&cell.colony_id, sizeof(int), 1, file) != 1) {
+                print_error("Failed to read grid data");
+                fclose(file);
+                destroy_world(world);
+                return NULL;
+            }
+            
+            set_terrain(world, x, y, cell.terrain);
+            set_food_amount(world, x, y, cell.food_amount);
+            set_nest_colony(world, x, y, cell.colony_id);
         }
     }
     
@@ -210,37 +257,25 @@ World* load_simulation(const char* filename) {
             if (ant_id == -1) break; // End marker
             
             // Read ant data
-            Position pos, last_pos;
-            uint8_t state;
-            int colony_id;
-            float energy;
-            int food_carrying, steps_taken, food_delivered;
+            Ant ant;
+            ant.id = ant_id;
             
-            if (fread(&pos, sizeof(Position), 1, file) != 1 ||
-                fread(&last_pos, sizeof(Position), 1, file) != 1 ||
-                fread(&state, sizeof(uint8_t), 1, file) != 1 ||
-                fread(&colony_id, sizeof(int), 1, file) != 1 ||
-                fread(&energy, sizeof(float), 1, file) != 1 ||
-                fread(&food_carrying, sizeof(int), 1, file) != 1 ||
-                fread(&steps_taken, sizeof(int), 1, file) != 1 ||
-                fread(&food_delivered, sizeof(int), 1, file) != 1) {
+            if (fread(&ant.pos, sizeof(Position), 1, file) != 1 ||
+                fread(&ant.last_pos, sizeof(Position), 1, file) != 1 ||
+                fread(&ant.state, sizeof(uint8_t), 1, file) != 1 ||
+                fread(&ant.colony_id, sizeof(int), 1, file) != 1 ||
+                fread(&ant.energy, sizeof(float), 1, file) != 1 ||
+                fread(&ant.food_carrying, sizeof(int), 1, file) != 1 ||
+                fread(&ant.steps_taken, sizeof(int), 1, file) != 1 ||
+                fread(&ant.food_delivered, sizeof(int), 1, file) != 1) {
                 print_error("Failed to read ant data");
                 fclose(file);
                 destroy_world(world);
                 return NULL;
             }
             
-            // Create and add ant
-            Ant* ant = create_ant(ant_id, colony_id, pos);
-            if (ant != NULL) {
-                ant->last_pos = last_pos;
-                ant->state = state;
-                ant->energy = energy;
-                ant->food_carrying = food_carrying;
-                ant->steps_taken = steps_taken;
-                ant->food_delivered = food_delivered;
-                add_ant_to_colony(colony, ant);
-            }
+            // Add the ant to the colony's store
+            restore_ant(colony, &ant);
         }
     }
     
@@ -318,10 +353,9 @@ int export_map(const World* world, const char* filename) {
     // Write map
     for (int y = 0; y < world->height; y++) {
         for (int x = 0; x < world->width; x++) {
-            Cell* cell = &world->grid[y][x];
             char symbol;
             
-            switch (cell->terrain) {
+            switch (get_terrain(world, x, y)) {
                 case TERRAIN_NEST: symbol = 'N'; break;
                 case TERRAIN_FOOD: symbol = 'F'; break;
                 case TERRAIN_WALL: symbol = '#'; break;
@@ -371,20 +405,20 @@ int load_map(World* world, const char* filename) {
                 // Find which colony this nest belongs to
                 for (int c = 0; c < world->colony_count; c++) {
                     if (world->colonies[c].nest_pos.x == x && world->colonies[c].nest_pos.y == y) {
-                        world->grid[y][x].terrain = TERRAIN_NEST;
-                        world->grid[y][x].colony_id = c;
+                        set_terrain(world, x, y, TERRAIN_NEST);
+                        set_nest_colony(world, x, y, c);
                         break;
                     }
                 }
             } else if (symbol == 'F') {
-                world->grid[y][x].terrain = TERRAIN_FOOD;
-                world->grid[y][x].food_amount = 50; // Default food amount
+                set_terrain(world, x, y, TERRAIN_FOOD);
+                set_food_amount(world, x, y, 50); // Default food amount
             } else if (symbol == '#') {
-                world->grid[y][x].terrain = TERRAIN_WALL;
+                set_terrain(world, x, y, TERRAIN_WALL);
             } else if (symbol == '~') {
-                world->grid[y][x].terrain = TERRAIN_WATER;
+                set_terrain(world, x, y, TERRAIN_WATER);
             } else {
-                world->grid[y][x].terrain = TERRAIN_EMPTY;
+                set_terrain(world, x, y, TERRAIN_EMPTY);
             }
             
             x++;
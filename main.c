@@ -9,36 +9,124 @@
 // Global variables for program state
 static World* g_world = NULL;
 static int g_program_running = 1;
+static int g_lazy_evaporation = 0;
+static int g_pheromone_block_steps = PHEROMONE_BLOCK_STEPS;
+static int g_pheromone_gradients = 0;
+static int g_initial_ants = INITIAL_ANTS_PER_COLONY;
+static int g_ant_capacity = DEFAULT_ANTS_PER_COLONY;
+static int g_path_length = PATH_HISTORY_LENGTH;
+static int g_ant_sort_interval = DEFAULT_ANT_SORT_INTERVAL;
 
 // Main program functions
 int main(int argc, char* argv[]) {
     initialize_program();
     
     // Handle command line arguments
-    if (argc > 1) {
-        if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
+    const char* load_file = NULL;
+    const char* trace_file = NULL;
+    int test_mode = 0;
+    int benchmark_mode = 0;
+    int thread_count = DEFAULT_THREAD_COUNT;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             printf("Ant Colony Optimization Simulator\n");
             printf("Usage: %s [options]\n", argv[0]);
             printf("Options:\n");
             printf("  --help, -h     Show this help message\n");
             printf("  --load <file>  Load simulation from file\n");
             printf("  --test         Run test scenario\n");
+            printf("  --test-suite   Check the SIMD kernels and pheromone decay\n");
+            printf("  --benchmark    Compare ant steps in spawn order and Hilbert order\n");
+            printf("  --threads <n>  Worker threads for the pheromone and ant updates (0 = all cores)\n");
+            printf("  --lazy-decay   Decay-only pheromones, evaporated lazily on access\n");
+            printf("  --block-steps <k>  Advance pheromones k steps per tile visit (1-%d)\n",
+                   MAX_PHEROMONE_BLOCK_STEPS);
+            printf("  --gradients    Precompute trail directions after each pheromone update\n");
+            printf("  --ants <n>     Initial ants per colony (default %d)\n", INITIAL_ANTS_PER_COLONY);
+            printf("  --max-ants <n> Most live ants per colony (default %d, up to %d)\n",
+                   DEFAULT_ANTS_PER_COLONY, MAX_ANTS_PER_COLONY);
+            printf("  --path-length <n>  Recent positions kept per ant (default %d, 0 = off)\n",
+                   PATH_HISTORY_LENGTH);
+            printf("  --sort-interval <n>  Re-sort ants by position every n steps (default %d, 0 = off)\n",
+                   DEFAULT_ANT_SORT_INTERVAL);
+            printf("  --seed <n>     Random seed, for reproducible runs (default: clock)\n");
+            printf("  --trace <file> Record ant events to a binary trace (decode with trace_decode)\n");
+            printf("  --log-level <level>  error, warning, info, debug or trace (default %s)\n",
+                   get_log_level_name(DEFAULT_LOG_LEVEL));
             return 0;
-        } else if (strcmp(argv[1], "--load") == 0 && argc > 2) {
-            g_world = load_simulation(argv[2]);
-            if (g_world == NULL) {
-                print_error("Failed to load simulation from %s", argv[2]);
-                return 1;
-            }
-        } else if (strcmp(argv[1], "--test") == 0) {
-            g_world = create_world(DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT, 2);
-            if (g_world != NULL) {
-                create_test_scenario(g_world);
-                spawn_initial_ants(g_world);
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            load_file = argv[++i];
+        } else if (strcmp(argv[i], "--test") == 0) {
+            test_mode = 1;
+        } else if (strcmp(argv[i], "--test-suite") == 0) {
+            int failures = check_ant_kernels(ANT_KERNEL_CHECK_ROUNDS) +
+                           check_pheromone_kernels(PHEROMONE_KERNEL_CHECK_ROUNDS) +
+                           check_pheromone_decay();
+            cleanup_program();
+            return failures == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            benchmark_mode = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--lazy-decay") == 0) {
+            g_lazy_evaporation = 1;
+        } else if (strcmp(argv[i], "--block-steps") == 0 && i + 1 < argc) {
+            g_pheromone_block_steps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gradients") == 0) {
+            g_pheromone_gradients = 1;
+        } else if (strcmp(argv[i], "--ants") == 0 && i + 1 < argc) {
+            g_initial_ants = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-ants") == 0 && i + 1 < argc) {
+            g_ant_capacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--path-length") == 0 && i + 1 < argc) {
+            g_path_length = clamp_int(atoi(argv[++i]), 0, MAX_PATH_HISTORY_LENGTH);
+        } else if (strcmp(argv[i], "--sort-interval") == 0 && i + 1 < argc) {
+            g_ant_sort_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            set_random_seed(strtoull(argv[++i], NULL, 10));
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            int level = parse_log_level(argv[++i]);
+            if (level < 0) {
+                print_warning("Unknown log level '%s'", argv[i]);
+            } else {
+                set_log_level(level);
             }
         }
     }
     
+    // A larger initial population raises the default capacity with it
+    if (g_initial_ants > g_ant_capacity) {
+        g_ant_capacity = g_initial_ants;
+    }
+    
+    init_thread_pool(thread_count);
+    if (benchmark_mode) {
+        int result = run_ant_benchmark();
+        cleanup_program();
+        return result;
+    }
+    if (trace_file != NULL) {
+        start_trace_log(trace_file);
+    }
+    
+    if (load_file != NULL) {
+        g_world = load_simulation(load_file);
+        if (g_world == NULL) {
+            print_error("Failed to load simulation from %s", load_file);
+            return 1;
+        }
+    } else if (test_mode) {
+        g_world = create_world(DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT, 2);
+        if (g_world != NULL) {
+            create_test_scenario(g_world);
+            set_ant_population(g_world, g_initial_ants, g_ant_capacity);
+            spawn_initial_ants(g_world);
+        }
+    }
+    
     // If no world was created, show main menu
     if (g_world == NULL) {
         show_main_menu();
@@ -66,6 +154,16 @@ void run_simulation(World* world) {
     
     print_info("Starting simulation...");
     world->is_running = 1;
+    set_lazy_evaporation(world, g_lazy_evaporation);
+    set_pheromone_block_steps(world, g_pheromone_block_steps);
+    set_pheromone_gradients(world, g_pheromone_gradients);
+    set_ant_population(world, g_initial_ants, g_ant_capacity);
+    set_ant_sort_interval(world, g_ant_sort_interval);
+    for (int i = 0; i < world->colony_count; i++) {
+        if (world->colonies[i].path_length != g_path_length) {
+            set_path_history_length(&world->colonies[i], g_path_length);
+        }
+    }
     
     // Main simulation loop
     while (world->is_running && g_program_running) {
@@ -77,8 +175,13 @@ void run_simulation(World* world) {
         if (!world->paused) {
             // Update simulation
             update_all_ants(world);
-            evaporate_pheromones(world);
-            diffuse_pheromones(world);
+            if (world->lazy_evaporation) {
+                // Diffusion would touch every tile; decay alone is O(1)
+                evaporate_pheromones(world);
+            } else {
+                // Runs once a whole block of steps is queued
+                queue_pheromone_step(world);
+            }
             update_colony_statistics(world);
             
             world->current_step++;
@@ -91,14 +194,7 @@ void run_simulation(World* world) {
             }
             
             // Check if all food is collected
-            int total_food = 0;
-            for (int y = 0; y < world->height; y++) {
-                for (int x = 0; x < world->width; x++) {
-                    if (world->grid[y][x].terrain == TERRAIN_FOOD) {
-                        total_food += world->grid[y][x].food_amount;
-                    }
-                }
-            }
+            int total_food = count_total_food(world);
             
             if (total_food == 0) {
                 print_info("All food collected! Simulation complete.");
@@ -119,6 +215,7 @@ void run_simulation(World* world) {
         sleep_ms(world->render_delay_ms);
     }
     
+    flush_pheromone_steps(world);
     print_info("Simulation ended");
 }
 
@@ -141,6 +238,7 @@ void handle_user_input(World* world) {
             {
                 char filename[256];
                 snprintf(filename, sizeof(filename), "data/saves/simulation_%d.sav", world->current_step);
+                flush_pheromone_steps(world);
                 if (save_simulation(world, filename) == FILE_IO_SUCCESS) {
                     print_info("Simulation saved to %s", filename);
                 }
@@ -266,11 +364,11 @@ void create_new_simulation(void) {
     
     int width, height, colonies;
     
-    printf("Enter world width (10-100): ");
+    printf("Enter world width (10-%d): ", MAX_WORLD_SIZE);
     scanf("%d", &width);
     width = clamp_int(width, 10, MAX_WORLD_SIZE);
     
-    printf("Enter world height (10-100): ");
+    printf("Enter world height (10-%d): ", MAX_WORLD_SIZE);
     scanf("%d", &height);
     height = clamp_int(height, 10, MAX_WORLD_SIZE);
     
@@ -290,6 +388,7 @@ void create_new_simulation(void) {
         
         // Initialize world
         initialize_world_random(g_world);
+        set_ant_population(g_world, g_initial_ants, g_ant_capacity);
         spawn_initial_ants(g_world);
         
         print_info("New simulation created successfully!");
@@ -324,6 +423,7 @@ void create_test_simulation(void) {
     g_world = create_world(DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT, 2);
     if (g_world != NULL) {
         create_test_scenario(g_world);
+        set_ant_population(g_world, g_initial_ants, g_ant_capacity);
         spawn_initial_ants(g_world);
         print_info("Test simulation created successfully!");
         sleep_ms(2000);
@@ -345,13 +445,35 @@ void show_settings_menu(World* world) {
     printf("Render Delay: %d ms\n", world->render_delay_ms);
     printf("World Size: %dx%d\n", world->width, world->height);
     printf("Colonies: %d\n", world->colony_count);
+    printf("Allocated Tiles: %d/%d\n", world->allocated_tiles, world->tiles_x * world->tiles_y);
+    printf("Active Pheromone Tiles: %d\n", count_active_tiles(world));
+    printf("Worker Threads: %d\n", get_thread_count());
+    printf("Pheromone Decay: %s\n", world->lazy_evaporation ? "lazy (no diffusion)" : "per step");
+    printf("Pheromone Block Steps: %d\n", world->pheromone_block_steps);
+    printf("Gradient Directions: %s\n", world->pheromone_gradients ? "precomputed" : "scanned");
+    printf("Ants per Colony: %d initial, %d max\n", world->initial_ants, world->ant_capacity);
+    if (world->ant_sort_interval > 0) {
+        printf("Ant Order: Hilbert curve, re-sorted every %d steps\n", world->ant_sort_interval);
+    } else {
+        printf("Ant Order: spawn order\n");
+    }
+    printf("Random Seed: %llu\n", (unsigned long long)get_random_seed());
+    printf("Log Level: %s (built up to %s)\n", get_log_level_name(log_level),
+           get_log_level_name(LOG_COMPILE_LEVEL));
+    for (int i = 0; i < world->colony_count; i++) {
+        const SlabPool* pool = &world->colonies[i].path_pool;
+        printf("Colony %d Path History: %d positions, %d/%d rings in %d slab(s), peak %d, %zu KB\n",
+               i, world->colonies[i].path_length, pool->in_use, get_slab_pool_capacity(pool),
+               pool->slab_count, pool->peak_in_use, get_slab_pool_bytes(pool) / 1024);
+    }
     printf("\n");
     
     printf("1. Change render delay\n");
     printf("2. Export current map\n");
     printf("3. Reset pheromones\n");
-    printf("4. Back to main menu\n");
-    printf("\nEnter your choice (1-4): ");
+    printf("4. Change log level\n");
+    printf("5. Back to main menu\n");
+    printf("\nEnter your choice (1-5): ");
     
     int choice;
     scanf("%d", &choice);
@@ -378,6 +500,21 @@ void show_settings_menu(World* world) {
             print_info("Pheromones reset");
             break;
         case 4:
+            {
+                char name[16];
+                printf("Enter log level (error, warning, info, debug, trace): ");
+                if (scanf("%15s", name) == 1) {
+                    int level = parse_log_level(name);
+                    if (level < 0) {
+                        print_warning("Unknown log level '%s'", name);
+                    } else {
+                        set_log_level(level);
+                        print_info("Log level set to %s", get_log_level_name(log_level));
+                    }
+                }
+            }
+            break;
+        case 5:
             return;
         default:
             print_warning("Invalid choice");
@@ -420,16 +557,7 @@ void reset_simulation(World* world) {
         
         // Clear all ants
         for (int i = 0; i < world->colony_count; i++) {
-            Colony* colony = &world->colonies[i];
-            Ant* current = colony->ants_head;
-            while (current != NULL) {
-                Ant* next = current->next;
-                destroy_ant(current);
-                current = next;
-            }
-            colony->ants_head = NULL;
-            colony->total_ants = 0;
-            colony->active_ants = 0;
+            release_colony_ants(&world->colonies[i]);
         }
         
         // Spawn new ants
@@ -456,6 +584,10 @@ void initialize_program(void) {
     // Initialize random number generator
     init_random();
     
+    // Pick the fastest pheromone and ant kernels this CPU supports
+    init_pheromone_kernels();
+    init_ant_kernels();
+    
     print_info("Program initialization complete");
 }
 
@@ -469,6 +601,10 @@ void cleanup_program(void) {
         g_world = NULL;
     }
     
+    // Flush the event trace, then stop the worker threads
+    stop_trace_log();
+    shutdown_thread_pool();
+    
     // Cleanup console
     cleanup_console();
     
@@ -7,6 +7,12 @@
 #include "world.h"
 #include "ant_logic.h"
 #include "pheromones.h"
+#include "pheromone_kernels.h"
+#include "ant_kernels.h"
+#include "thread_pool.h"
+#include "slab_pool.h"
+#include "trace_log.h"
+#include "benchmark.h"
 #include "visualization.h"
 #include "file_io.h"
 #include "algorithms.h"
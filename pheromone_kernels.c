@@ -0,0 +1,540 @@
+#include "pheromone_kernels.h"
+#include "config.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+// SIMD paths are only built for x86 targets
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define PHEROMONE_SIMD_X86 1
+    #include <immintrin.h>
+#else
+    #define PHEROMONE_SIMD_X86 0
+#endif
+
+// GCC and Clang need per-function ISA targets; MSVC accepts the intrinsics as is
+#if PHEROMONE_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+    #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SIMD_TARGET_SSE2
+    #define SIMD_TARGET_AVX2
+#endif
+
+#define EVAPORATION_KEEP (1.0f - PHEROMONE_EVAPORATION_RATE)
+#define DIFFUSION_KEEP (1.0f - PHEROMONE_DIFFUSION_RATE)
+
+// Scalar reference kernels
+#define LOAD_LEVEL(level) PHEROMONE_LEVEL_TO_FLOAT(level)
+#define STORE_LEVEL(value) PHEROMONE_LEVEL_FROM_FLOAT(value)
+
+static float evaporated_level(float level) {
+    level *= EVAPORATION_KEEP;
+    return (level < PHEROMONE_CUTOFF) ? 0.0f : level;
+}
+
+static void evaporate_scalar(PheromoneLevel* levels, int count) {
+    for (int x = 0; x < count; x++) {
+        levels[x] = STORE_LEVEL(evaporated_level(LOAD_LEVEL(levels[x])));
+    }
+}
+
+static void spread_scalar(float* shares, const PheromoneLevel* levels, float weight, int count) {
+    for (int x = 0; x < count; x++) {
+        shares[x] = evaporated_level(LOAD_LEVEL(levels[x])) * weight;
+    }
+}
+
+static void step_row_scalar(PheromoneLevel* out, const PheromoneLevel* levels, const float* up,
+                            const float* mid, const float* down, int count) {
+    for (int x = 0; x < count; x++) {
+        float level = evaporated_level(LOAD_LEVEL(levels[x])) * DIFFUSION_KEEP
+                    + up[x - 1] + up[x] + up[x + 1]
+                    + mid[x - 1] + mid[x + 1]
+                    + down[x - 1] + down[x] + down[x + 1];
+        out[x] = STORE_LEVEL((level > PHEROMONE_MAX) ? PHEROMONE_MAX : level);
+    }
+}
+
+static float find_max_scalar(const PheromoneLevel* levels, int count, float max_value) {
+    for (int x = 0; x < count; x++) {
+        float level = LOAD_LEVEL(levels[x]);
+        if (level > max_value) {
+            max_value = level;
+        }
+    }
+    return max_value;
+}
+
+static void scale_scalar(PheromoneLevel* levels, int count, float max_value) {
+    for (int x = 0; x < count; x++) {
+        levels[x] = STORE_LEVEL((LOAD_LEVEL(levels[x]) / max_value) * PHEROMONE_MAX);
+    }
+}
+
+static void gradient_row_scalar(uint8_t* out, const float* up, const float* mid,
+                                const float* down, int count) {
+    for (int x = 0; x < count; x++) {
+        const float neighbors[8] = { up[x], up[x + 1], mid[x + 1], down[x + 1],
+                                     down[x], down[x - 1], mid[x - 1], up[x - 1] };
+        float best = 0.0f;
+        uint8_t direction = GRADIENT_NONE;
+        for (int d = 0; d < 8; d++) {
+            if (neighbors[d] > best) {
+                best = neighbors[d];
+                direction = (uint8_t)d;
+            }
+        }
+        out[x] = direction;
+    }
+}
+
+static const PheromoneKernels scalar_kernels = {
+    "scalar",
+    evaporate_scalar,
+    spread_scalar,
+    step_row_scalar,
+    find_max_scalar,
+    scale_scalar,
+    gradient_row_scalar
+};
+
+#if PHEROMONE_SIMD_X86
+// SSE2 kernels: 4 cells per iteration, scalar tail. Operations are applied in
+// the same order as the scalar code so results match bit for bit.
+SIMD_TARGET_SSE2
+static __m128 load_levels_sse2(const PheromoneLevel* levels) {
+#if PHEROMONE_FIXED16
+    __m128i wide = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)levels), _mm_setzero_si128());
+    return _mm_mul_ps(_mm_cvtepi32_ps(wide), _mm_set1_ps(1.0f / PHEROMONE_FIXED_SCALE));
+#else
+    return _mm_loadu_ps(levels);
+#endif
+}
+
+SIMD_TARGET_SSE2
+static void store_levels_sse2(PheromoneLevel* levels, __m128 value) {
+#if PHEROMONE_FIXED16
+    value = _mm_mul_ps(value, _mm_set1_ps(PHEROMONE_FIXED_SCALE));
+    // SSE2 only has a signed saturating pack: bias 0..65535 into the signed
+    // range, pack, then flip the top bit back
+    __m128i wide = _mm_sub_epi32(_mm_cvttps_epi32(value), _mm_set1_epi32(32768));
+    __m128i narrow = _mm_xor_si128(_mm_packs_epi32(wide, wide), _mm_set1_epi16((short)0x8000));
+    _mm_storel_epi64((__m128i*)levels, narrow);
+#else
+    _mm_storeu_ps(levels, value);
+#endif
+}
+
+SIMD_TARGET_SSE2
+static __m128 evaporated_level_sse2(__m128 level) {
+    level = _mm_mul_ps(level, _mm_set1_ps(EVAPORATION_KEEP));
+    return _mm_andnot_ps(_mm_cmplt_ps(level, _mm_set1_ps(PHEROMONE_CUTOFF)), level);
+}
+
+SIMD_TARGET_SSE2
+static void evaporate_sse2(PheromoneLevel* levels, int count) {
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        store_levels_sse2(levels + x, evaporated_level_sse2(load_levels_sse2(levels + x)));
+    }
+    evaporate_scalar(levels + x, count - x);
+}
+
+SIMD_TARGET_SSE2
+static void spread_sse2(float* shares, const PheromoneLevel* levels, float weight, int count) {
+    __m128 w = _mm_set1_ps(weight);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_ps(shares + x, _mm_mul_ps(evaporated_level_sse2(load_levels_sse2(levels + x)), w));
+    }
+    spread_scalar(shares + x, levels + x, weight, count - x);
+}
+
+SIMD_TARGET_SSE2
+static void step_row_sse2(PheromoneLevel* out, const PheromoneLevel* levels, const float* up,
+                          const float* mid, const float* down, int count) {
+    __m128 keep = _mm_set1_ps(DIFFUSION_KEEP);
+    __m128 max_level = _mm_set1_ps(PHEROMONE_MAX);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128 level = _mm_mul_ps(evaporated_level_sse2(load_levels_sse2(levels + x)), keep);
+        level = _mm_add_ps(level, _mm_loadu_ps(up + x - 1));
+        level = _mm_add_ps(level, _mm_loadu_ps(up + x));
+        level = _mm_add_ps(level, _mm_loadu_ps(up + x + 1));
+        level = _mm_add_ps(level, _mm_loadu_ps(mid + x - 1));
+        level = _mm_add_ps(level, _mm_loadu_ps(mid + x + 1));
+        level = _mm_add_ps(level, _mm_loadu_ps(down + x - 1));
+        level = _mm_add_ps(level, _mm_loadu_ps(down + x));
+        level = _mm_add_ps(level, _mm_loadu_ps(down + x + 1));
+        store_levels_sse2(out + x, _mm_min_ps(level, max_level));
+    }
+    step_row_scalar(out + x, levels + x, up + x, mid + x, down + x, count - x);
+}
+
+SIMD_TARGET_SSE2
+static float find_max_sse2(const PheromoneLevel* levels, int count, float max_value) {
+    __m128 best = _mm_set1_ps(max_value);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        best = _mm_max_ps(best, load_levels_sse2(levels + x));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, best);
+    for (int i = 0; i < 4; i++) {
+        if (lanes[i] > max_value) {
+            max_value = lanes[i];
+        }
+    }
+    return find_max_scalar(levels + x, count - x, max_value);
+}
+
+SIMD_TARGET_SSE2
+static void scale_sse2(PheromoneLevel* levels, int count, float max_value) {
+    __m128 divisor = _mm_set1_ps(max_value);
+    __m128 factor = _mm_set1_ps(PHEROMONE_MAX);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128 level = _mm_div_ps(load_levels_sse2(levels + x), divisor);
+        store_levels_sse2(levels + x, _mm_mul_ps(level, factor));
+    }
+    scale_scalar(levels + x, count - x, max_value);
+}
+
+SIMD_TARGET_SSE2
+static void gradient_row_sse2(uint8_t* out, const float* up, const float* mid,
+                              const float* down, int count) {
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        const float* neighbors[8] = { up + x, up + x + 1, mid + x + 1, down + x + 1,
+                                      down + x, down + x - 1, mid + x - 1, up + x - 1 };
+        __m128 best = _mm_setzero_ps();
+        __m128i direction = _mm_set1_epi32(GRADIENT_NONE);
+        for (int d = 0; d < 8; d++) {
+            __m128 level = _mm_loadu_ps(neighbors[d]);
+            __m128i greater = _mm_castps_si128(_mm_cmpgt_ps(level, best));
+            best = _mm_max_ps(level, best);
+            direction = _mm_or_si128(_mm_and_si128(greater, _mm_set1_epi32(d)),
+                                     _mm_andnot_si128(greater, direction));
+        }
+        direction = _mm_packs_epi32(direction, direction);
+        int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(direction, direction));
+        memcpy(out + x, &bytes, 4);
+    }
+    gradient_row_scalar(out + x, up + x, mid + x, down + x, count - x);
+}
+
+static const PheromoneKernels sse2_kernels = {
+    "SSE2",
+    evaporate_sse2,
+    spread_sse2,
+    step_row_sse2,
+    find_max_sse2,
+    scale_sse2,
+    gradient_row_sse2
+};
+
+// AVX2 kernels: 8 cells per iteration, scalar tail
+SIMD_TARGET_AVX2
+static __m256 load_levels_avx2(const PheromoneLevel* levels) {
+#if PHEROMONE_FIXED16
+    __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)levels));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(wide), _mm256_set1_ps(1.0f / PHEROMONE_FIXED_SCALE));
+#else
+    return _mm256_loadu_ps(levels);
+#endif
+}
+
+SIMD_TARGET_AVX2
+static void store_levels_avx2(PheromoneLevel* levels, __m256 value) {
+#if PHEROMONE_FIXED16
+    value = _mm256_mul_ps(value, _mm256_set1_ps(PHEROMONE_FIXED_SCALE));
+    __m256i wide = _mm256_cvttps_epi32(value);
+    __m128i narrow = _mm_packus_epi32(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+    _mm_storeu_si128((__m128i*)levels, narrow);
+#else
+    _mm256_storeu_ps(levels, value);
+#endif
+}
+
+SIMD_TARGET_AVX2
+static __m256 evaporated_level_avx2(__m256 level) {
+    level = _mm256_mul_ps(level, _mm256_set1_ps(EVAPORATION_KEEP));
+    return _mm256_andnot_ps(_mm256_cmp_ps(level, _mm256_set1_ps(PHEROMONE_CUTOFF), _CMP_LT_OQ), level);
+}
+
+SIMD_TARGET_AVX2
+static void evaporate_avx2(PheromoneLevel* levels, int count) {
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        store_levels_avx2(levels + x, evaporated_level_avx2(load_levels_avx2(levels + x)));
+    }
+    evaporate_scalar(levels + x, count - x);
+}
+
+SIMD_TARGET_AVX2
+static void spread_avx2(float* shares, const PheromoneLevel* levels, float weight, int count) {
+    __m256 w = _mm256_set1_ps(weight);
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        _mm256_storeu_ps(shares + x, _mm256_mul_ps(evaporated_level_avx2(load_levels_avx2(levels + x)), w));
+    }
+    spread_scalar(shares + x, levels + x, weight, count - x);
+}
+
+SIMD_TARGET_AVX2
+static void step_row_avx2(PheromoneLevel* out, const PheromoneLevel* levels, const float* up,
+                          const float* mid, const float* down, int count) {
+    __m256 keep = _mm256_set1_ps(DIFFUSION_KEEP);
+    __m256 max_level = _mm256_set1_ps(PHEROMONE_MAX);
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256 level = _mm256_mul_ps(evaporated_level_avx2(load_levels_avx2(levels + x)), keep);
+        level = _mm256_add_ps(level, _mm256_loadu_ps(up + x - 1));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(up + x));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(up + x + 1));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(mid + x - 1));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(mid + x + 1));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(down + x - 1));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(down + x));
+        level = _mm256_add_ps(level, _mm256_loadu_ps(down + x + 1));
+        store_levels_avx2(out + x, _mm256_min_ps(level, max_level));
+    }
+    step_row_scalar(out + x, levels + x, up + x, mid + x, down + x, count - x);
+}
+
+SIMD_TARGET_AVX2
+static float find_max_avx2(const PheromoneLevel* levels, int count, float max_value) {
+    __m256 best = _mm256_set1_ps(max_value);
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        best = _mm256_max_ps(best, load_levels_avx2(levels + x));
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, best);
+    for (int i = 0; i < 8; i++) {
+        if (lanes[i] > max_value) {
+            max_value = lanes[i];
+        }
+    }
+    return find_max_scalar(levels + x, count - x, max_value);
+}
+
+SIMD_TARGET_AVX2
+static void scale_avx2(PheromoneLevel* levels, int count, float max_value) {
+    __m256 divisor = _mm256_set1_ps(max_value);
+    __m256 factor = _mm256_set1_ps(PHEROMONE_MAX);
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256 level = _mm256_div_ps(load_levels_avx2(levels + x), divisor);
+        store_levels_avx2(levels + x, _mm256_mul_ps(level, factor));
+    }
+    scale_scalar(levels + x, count - x, max_value);
+}
+
+SIMD_TARGET_AVX2
+static void gradient_row_avx2(uint8_t* out, const float* up, const float* mid,
+                              const float* down, int count) {
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const float* neighbors[8] = { up + x, up + x + 1, mid + x + 1, down + x + 1,
+                                      down + x, down + x - 1, mid + x - 1, up + x - 1 };
+        __m256 best = _mm256_setzero_ps();
+        __m256i direction = _mm256_set1_epi32(GRADIENT_NONE);
+        for (int d = 0; d < 8; d++) {
+            __m256 level = _mm256_loadu_ps(neighbors[d]);
+            __m256i greater = _mm256_castps_si256(_mm256_cmp_ps(level, best, _CMP_GT_OQ));
+            best = _mm256_max_ps(level, best);
+            direction = _mm256_blendv_epi8(direction, _mm256_set1_epi32(d), greater);
+        }
+        __m128i narrow = _mm_packs_epi32(_mm256_castsi256_si128(direction),
+                                         _mm256_extracti128_si256(direction, 1));
+        _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(narrow, narrow));
+    }
+    gradient_row_scalar(out + x, up + x, mid + x, down + x, count - x);
+}
+
+static const PheromoneKernels avx2_kernels = {
+    "AVX2",
+    evaporate_avx2,
+    spread_avx2,
+    step_row_avx2,
+    find_max_avx2,
+    scale_avx2,
+    gradient_row_avx2
+};
+
+#endif // PHEROMONE_SIMD_X86
+
+// Kernel selection
+static const PheromoneKernels* active_kernels = &scalar_kernels;
+
+void init_pheromone_kernels(void) {
+    active_kernels = &scalar_kernels;
+
+#if PHEROMONE_SIMD_X86
+    if (cpu_has_avx2()) {
+        active_kernels = &avx2_kernels;
+    } else if (cpu_has_sse2()) {
+        active_kernels = &sse2_kernels;
+    }
+#endif
+
+    print_info("Pheromone kernels: %s, %s levels", active_kernels->name,
+               PHEROMONE_FIXED16 ? "16-bit fixed-point" : "float");
+}
+
+const PheromoneKernels* get_pheromone_kernels(void) {
+    return active_kernels;
+}
+
+const PheromoneKernels* get_scalar_pheromone_kernels(void) {
+    return &scalar_kernels;
+}
+
+// Equivalence check. Levels and shares are drawn from small sets so that
+// the cut-off, the PHEROMONE_MAX clamp and ties all come up; row lengths
+// and start offsets vary so every kernel's scalar tail runs.
+#define CHECK_ROW_CELLS (2 * WORLD_TILE_SIZE + 16)
+
+static void fill_check_levels(PheromoneLevel* levels, int count) {
+    for (int x = 0; x < count; x++) {
+        uint32_t r = random_uint32();
+        float level;
+        switch (r & 7) {
+            case 0: level = 0.0f; break;
+            case 1: level = PHEROMONE_CUTOFF; break;
+            case 2: level = PHEROMONE_CUTOFF / EVAPORATION_KEEP; break;
+            case 3: level = PHEROMONE_MAX; break;
+            default: level = RANDOM_DRAW_UNIT(r) * PHEROMONE_MAX; break;
+        }
+        levels[x] = STORE_LEVEL(level);
+    }
+}
+
+// count + 2 entries: the padding cells on both sides are filled too
+static void fill_check_shares(float* row, int count) {
+    for (int x = 0; x < count + 2; x++) {
+        uint32_t r = random_uint32();
+        row[x] = (r & 3) ? (float)((r >> 2) & 7) * (PHEROMONE_MAX / 32.0f) : 0.0f;
+    }
+}
+
+// Only the first mismatch of a kernel table is reported in full
+static int compare_kernel_output(const PheromoneKernels* kernels, const char* function,
+                                 const void* expected, const void* actual, size_t size, int count,
+                                 int* reported) {
+    if (memcmp(expected, actual, size) == 0) return 0;
+    if (*reported) return 1;
+    *reported = 1;
+    print_error("Pheromone kernel %s: %s differs from the scalar reference on a row of %d cells",
+                kernels->name, function, count);
+    return 1;
+}
+
+// One random row through every function of kernels; returns the number of
+// functions whose output differs
+static int check_kernel_row(const PheromoneKernels* kernels, int count, int offset, int* reported) {
+    static PheromoneLevel levels[CHECK_ROW_CELLS], expected[CHECK_ROW_CELLS], actual[CHECK_ROW_CELLS];
+    static float expected_shares[CHECK_ROW_CELLS], actual_shares[CHECK_ROW_CELLS];
+    static float up[CHECK_ROW_CELLS + 2], mid[CHECK_ROW_CELLS + 2], down[CHECK_ROW_CELLS + 2];
+    static uint8_t expected_directions[CHECK_ROW_CELLS], actual_directions[CHECK_ROW_CELLS];
+    const PheromoneKernels* reference = get_scalar_pheromone_kernels();
+    PheromoneLevel* row = levels + offset;
+    size_t level_bytes = (size_t)count * sizeof(PheromoneLevel);
+    int mismatches = 0;
+
+    fill_check_levels(row, count);
+    fill_check_shares(up + offset, count);
+    fill_check_shares(mid + offset, count);
+    fill_check_shares(down + offset, count);
+    const float* up_row = up + offset + 1;
+    const float* mid_row = mid + offset + 1;
+    const float* down_row = down + offset + 1;
+
+    memcpy(expected + offset, row, level_bytes);
+    memcpy(actual + offset, row, level_bytes);
+    reference->evaporate(expected + offset, count);
+    kernels->evaporate(actual + offset, count);
+    mismatches += compare_kernel_output(kernels, "evaporate", expected + offset, actual + offset, level_bytes,
+                                        count, reported);
+
+    float weight = PHEROMONE_DIFFUSION_RATE / 8.0f;
+    reference->spread(expected_shares + offset, row, weight, count);
+    kernels->spread(actual_shares + offset, row, weight, count);
+    mismatches += compare_kernel_output(kernels, "spread", expected_shares + offset, actual_shares + offset,
+                                        (size_t)count * sizeof(float), count, reported);
+
+    reference->step_row(expected + offset, row, up_row, mid_row, down_row, count);
+    kernels->step_row(actual + offset, row, up_row, mid_row, down_row, count);
+    mismatches += compare_kernel_output(kernels, "step_row", expected + offset, actual + offset, level_bytes,
+                                        count, reported);
+
+    float expected_max = reference->find_max(row, count, PHEROMONE_CUTOFF);
+    float actual_max = kernels->find_max(row, count, PHEROMONE_CUTOFF);
+    mismatches += compare_kernel_output(kernels, "find_max", &expected_max, &actual_max, sizeof(float),
+                                        count, reported);
+
+    // find_max bounds every level, as normalize_pheromones relies on
+    memcpy(expected + offset, row, level_bytes);
+    memcpy(actual + offset, row, level_bytes);
+    reference->scale(expected + offset, count, expected_max);
+    kernels->scale(actual + offset, count, expected_max);
+    mismatches += compare_kernel_output(kernels, "scale", expected + offset, actual + offset, level_bytes,
+                                        count, reported);
+
+    // Gradients: the share values already tie often; a run zeroed across
+    // all three rows adds cells with no trail around them
+    int run_start = RANDOM_DRAW_BELOW(random_uint32(), count + 2);
+    int run_end = run_start + RANDOM_DRAW_BELOW(random_uint32(), 16);
+    for (int x = run_start; x < run_end && x < count + 2; x++) {
+        up[offset + x] = mid[offset + x] = down[offset + x] = 0.0f;
+    }
+    reference->gradient_row(expected_directions + offset, up_row, mid_row, down_row, count);
+    kernels->gradient_row(actual_directions + offset, up_row, mid_row, down_row, count);
+    mismatches += compare_kernel_output(kernels, "gradient_row", expected_directions + offset,
+                                        actual_directions + offset, (size_t)count, count, reported);
+
+    return mismatches;
+}
+
+int check_pheromone_kernels(int rounds) {
+    const PheromoneKernels* candidates[2];
+    int candidate_count = 0;
+#if PHEROMONE_SIMD_X86
+    if (cpu_has_sse2()) {
+        candidates[candidate_count++] = &sse2_kernels;
+    }
+    if (cpu_has_avx2()) {
+        candidates[candidate_count++] = &avx2_kernels;
+    }
+#endif
+    if (candidate_count == 0) {
+        print_info("Pheromone kernels: only the scalar reference is supported here");
+        return 0;
+    }
+
+    int total_mismatches = 0;
+    for (int c = 0; c < candidate_count; c++) {
+        int mismatches = 0;
+        int reported = 0;
+        for (int round = 0; round < rounds; round++) {
+            // Every length down to one cell, starting off the vector grain
+            int count = CHECK_ROW_CELLS - 8 - round % (CHECK_ROW_CELLS - 8);
+            int offset = round % 8;
+            mismatches += check_kernel_row(candidates[c], count, offset, &reported);
+        }
+
+        if (mismatches == 0) {
+            print_info("Pheromone kernel %s matches the scalar reference (%d rows, %s levels)",
+                       candidates[c]->name, rounds, PHEROMONE_FIXED16 ? "16-bit fixed-point" : "float");
+        } else {
+            print_error("Pheromone kernel %s: %d outputs in %d rows differ from the scalar reference",
+                        candidates[c]->name, mismatches, rounds);
+        }
+        total_mismatches += mismatches;
+    }
+    return total_mismatches;
+}
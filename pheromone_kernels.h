@@ -0,0 +1,47 @@
+#ifndef PHEROMONE_KERNELS_H
+#define PHEROMONE_KERNELS_H
+
+#include "data_structures.h"
+
+// Inner loops of the pheromone field update. Every implementation produces
+// bit-identical results; the fastest one supported by the CPU is selected
+// at startup by init_pheromone_kernels(). Levels are read and written in
+// their storage format (PheromoneLevel) and widened to float in registers;
+// share rows are always float.
+typedef struct {
+    const char* name;
+
+    // Decay count levels in place, zeroing traces below the cut-off
+    void (*evaporate)(PheromoneLevel* levels, int count);
+
+    // shares[x] = evaporated(levels[x]) * weight
+    void (*spread)(float* shares, const PheromoneLevel* levels, float weight, int count);
+
+    // Diffusion stencil for one row; up, mid and down are padded share rows
+    // aligned with x = 0 (index -1 and count must be readable)
+    void (*step_row)(PheromoneLevel* out, const PheromoneLevel* levels, const float* up,
+                     const float* mid, const float* down, int count);
+
+    // Largest of max_value and levels[0..count)
+    float (*find_max)(const PheromoneLevel* levels, int count, float max_value);
+
+    // levels[x] = levels[x] / max_value * PHEROMONE_MAX
+    void (*scale)(PheromoneLevel* levels, int count, float max_value);
+    
+    // out[x] = direction (0-7, in dx/dy order) of the highest of the 8 levels
+    // around x, the first one on ties, or GRADIENT_NONE if none is above 0.
+    // up, mid and down are padded float rows as for step_row.
+    void (*gradient_row)(uint8_t* out, const float* up, const float* mid, const float* down, int count);
+} PheromoneKernels;
+
+// Kernel selection
+void init_pheromone_kernels(void);
+const PheromoneKernels* get_pheromone_kernels(void);
+const PheromoneKernels* get_scalar_pheromone_kernels(void);
+
+// Run every kernel table the CPU supports on random rows and compare each
+// function's output with the scalar reference; returns the number of
+// mismatching outputs
+int check_pheromone_kernels(int rounds);
+
+#endif // PHEROMONE_KERNELS_H
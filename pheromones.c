@@ -2,211 +2,789 @@
 #include "config.h"
 #include "utils.h"
 #include "world.h"
+#include "pheromone_kernels.h"
+#include "thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+// Channel holding a colony's trail of the given type, -1 if either is invalid
+static int pheromone_channel(const World* world, int colony_id, int type) {
+    if (type != PHEROMONE_TYPE_FOOD && type != PHEROMONE_TYPE_HOME) return -1;
+    if (colony_id < 0 || colony_id >= world->colony_count) return -1;
+    return PHEROMONE_CHANNEL(colony_id, type);
+}
+
+// Level count of all channel planes in one tile buffer
+static int tile_level_count(const World* world) {
+    return world->pheromone_channels * WORLD_TILE_CELLS;
+}
+
+// Whether any cell of the tile still holds pheromone
+static int tile_has_pheromone(const World* world, const WorldTile* tile,
+                              const PheromoneKernels* kernels) {
+    return kernels->find_max(TILE_PHEROMONE(tile, 0), tile_level_count(world), 0.0f) > 0.0f;
+}
+
+// Lazy evaporation. decay_power[n] is the fraction left after n steps; a
+// gap past the end of the table has decayed every level below the cut-off.
+static float decay_power[LAZY_DECAY_TABLE_SIZE];
+static int decay_power_ready = 0;
+
+static void init_decay_power(void) {
+    if (decay_power_ready) return;
+    
+    decay_power[0] = 1.0f;
+    for (int n = 1; n < LAZY_DECAY_TABLE_SIZE; n++) {
+        decay_power[n] = decay_power[n - 1] * (1.0f - PHEROMONE_EVAPORATION_RATE);
+    }
+    decay_power_ready = 1;
+}
+
+// Level after `steps` evaporation steps
+static float decayed_level(float level, uint32_t steps) {
+    if (steps == 0) return level;
+    if (steps >= LAZY_DECAY_TABLE_SIZE) return 0.0f;
+    
+    level *= decay_power[steps];
+    return (level < PHEROMONE_CUTOFF) ? 0.0f : level;
+}
+
+// Bring a tile's stored levels up to the pheromone clock
+static void settle_tile(const World* world, WorldTile* tile) {
+    uint32_t steps = world->pheromone_clock - tile->decay_stamp;
+    tile->decay_stamp = world->pheromone_clock;
+    if (steps == 0) return;
+    
+    PheromoneLevel* levels = TILE_PHEROMONE(tile, 0);
+    int count = tile_level_count(world);
+    for (int i = 0; i < count; i++) {
+        levels[i] = PHEROMONE_LEVEL_FROM_FLOAT(decayed_level(PHEROMONE_LEVEL_TO_FLOAT(levels[i]), steps));
+    }
+}
+
+// Inactive tiles hold no pheromone and have nothing to catch up on
+void settle_pheromone_decay(World* world) {
+    if (world == NULL) return;
+    
+    const PheromoneKernels* kernels = get_pheromone_kernels();
+    for (int tile_y = 0; tile_y < world->tiles_y; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            if (tile->decay_stamp == world->pheromone_clock) continue;
+            
+            settle_tile(world, tile);
+            if (!tile_has_pheromone(world, tile, kernels)) {
+                set_tile_active(world, tile_x, tile_y, 0);
+            }
+        }
+    }
+}
+
+void set_lazy_evaporation(World* world, int enabled) {
+    if (world == NULL) return;
+    
+    // Stored levels must be current before the mode changes
+    settle_pheromone_decay(world);
+    init_decay_power();
+    world->lazy_evaporation = enabled ? 1 : 0;
+}
+
 // Pheromone deposit and evaporation
-void deposit_pheromone(World* world, Ant* ant) {
-    if (world == NULL || ant == NULL) return;
+void deposit_pheromone(World* world, const Colony* colony, int index) {
+    if (world == NULL || colony == NULL) return;
     
-    Cell* cell = get_cell(world, ant->pos.x, ant->pos.y);
-    if (cell == NULL) return;
+    const AntStore* ants = &colony->ants;
+    int x = ants->x[index];
+    int y = ants->y[index];
     
-    if (ant->state & ANT_STATE_SEARCHING) {
+    if (ants->state[index] & ANT_STATE_SEARCHING) {
         // Searching ants deposit home pheromone
-        cell->pheromone_home += PHEROMONE_DEPOSIT_AMOUNT;
-        if (cell->pheromone_home > PHEROMONE_MAX) {
-            cell->pheromone_home = PHEROMONE_MAX;
-        }
+        deposit_pheromone_at_position(world, x, y, colony->id, PHEROMONE_TYPE_HOME, PHEROMONE_DEPOSIT_AMOUNT);
         
-        print_info("Ant %d deposited home pheromone at (%d, %d), level: %.1f", 
-                  ant->id, ant->pos.x, ant->pos.y, cell->pheromone_home);
+        LOG_TRACE("Ant %d deposited home pheromone at (%d, %d), level: %.1f", 
+                  ants->id[index], x, y,
+                  get_pheromone_intensity(world, x, y, colony->id, PHEROMONE_TYPE_HOME));
         
-    } else if (ant->state & ANT_STATE_RETURNING) {
+    } else if (ants->state[index] & ANT_STATE_RETURNING) {
         // Returning ants deposit food pheromone
-        cell->pheromone_food += PHEROMONE_DEPOSIT_AMOUNT;
-        if (cell->pheromone_food > PHEROMONE_MAX) {
-            cell->pheromone_food = PHEROMONE_MAX;
-        }
+        deposit_pheromone_at_position(world, x, y, colony->id, PHEROMONE_TYPE_FOOD, PHEROMONE_DEPOSIT_AMOUNT);
         
-        print_info("Ant %d deposited food pheromone at (%d, %d), level: %.1f", 
-                  ant->id, ant->pos.x, ant->pos.y, cell->pheromone_food);
+        LOG_TRACE("Ant %d deposited food pheromone at (%d, %d), level: %.1f", 
+                  ants->id[index], x, y,
+                  get_pheromone_intensity(world, x, y, colony->id, PHEROMONE_TYPE_FOOD));
     }
 }
 
-void deposit_pheromone_at_position(World* world, int x, int y, int type, float amount) {
+void deposit_pheromone_at_position(World* world, int x, int y, int colony_id, int type, float amount) {
     if (world == NULL || !is_valid_position(world, x, y)) return;
+    int channel = pheromone_channel(world, colony_id, type);
+    if (channel < 0) return;
+    
+    WorldTile* tile = get_or_create_tile(world, x, y);
+    if (tile == NULL) return;
+    settle_tile(world, tile);
     
-    Cell* cell = get_cell(world, x, y);
-    if (cell == NULL) return;
+    PheromoneLevel* plane = TILE_PHEROMONE(tile, channel);
+    int index = TILE_CELL_INDEX(x, y);
+    float level = PHEROMONE_LEVEL_TO_FLOAT(plane[index]) + amount;
+    if (level > PHEROMONE_MAX) {
+        level = PHEROMONE_MAX;
+    }
+    plane[index] = PHEROMONE_LEVEL_FROM_FLOAT(level);
+    invalidate_gradient_cells(world, x, y, channel);
     
-    if (type == PHEROMONE_TYPE_FOOD) {
-        cell->pheromone_food += amount;
-        if (cell->pheromone_food > PHEROMONE_MAX) {
-            cell->pheromone_food = PHEROMONE_MAX;
+    if (plane[index] > 0) {
+        set_tile_active(world, x >> WORLD_TILE_SHIFT, y >> WORLD_TILE_SHIFT, 1);
+    }
+}
+
+void set_pheromone_intensity(World* world, int x, int y, int colony_id, int type, float intensity) {
+    if (world == NULL || !is_valid_position(world, x, y)) return;
+    int channel = pheromone_channel(world, colony_id, type);
+    if (channel < 0) return;
+    
+    // Clearing a cell in an untouched region must not allocate its tile
+    WorldTile* tile = (intensity == 0.0f) ? get_tile(world, x, y) : get_or_create_tile(world, x, y);
+    if (tile == NULL) return;
+    settle_tile(world, tile);
+    
+    TILE_PHEROMONE(tile, channel)[TILE_CELL_INDEX(x, y)] =
+        PHEROMONE_LEVEL_FROM_FLOAT(clamp_float(intensity, 0.0f, PHEROMONE_MAX));
+    invalidate_gradient_cells(world, x, y, channel);
+    
+    if (intensity > 0.0f) {
+        set_tile_active(world, x >> WORLD_TILE_SHIFT, y >> WORLD_TILE_SHIFT, 1);
+    }
+}
+
+// Parallel sweeps split the tile directory into bands of whole tile rows
+// and only visit active tiles. Every tile is updated from its own front
+// buffer and the (read-only) front buffers of its neighbours, so the result
+// does not depend on how the bands are scheduled.
+typedef struct {
+    World* world;
+    const PheromoneKernels* kernels;
+    int evaporate;  // Diffusion sweeps: decay the levels in the same pass
+} PheromoneSweep;
+
+static int pheromone_band_count(const World* world) {
+    int bands = get_thread_count() * BANDS_PER_THREAD;
+    return (bands < world->tiles_y) ? bands : world->tiles_y;
+}
+
+static void band_tile_rows(const World* world, int band, int band_count, int* first, int* last) {
+    *first = (int)((long long)world->tiles_y * band / band_count);
+    *last = (int)((long long)world->tiles_y * (band + 1) / band_count);
+}
+
+// Best-direction planes. Each entry holds the direction
+// follow_pheromone_gradient would pick from that cell: the first walkable
+// neighbour with the highest level, or GRADIENT_NONE. Planes are rebuilt
+// for active tiles after every field pass; writes in between mark the
+// entries around the changed cell GRADIENT_STALE, so a plane entry always
+// agrees with a fresh neighbour scan.
+#define LEVEL_STRIDE (WORLD_TILE_SIZE + 2)
+
+// Stored level of the cell at (x, y), 0 outside the world
+static float stored_level(const World* world, int x, int y, int channel) {
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return 0.0f;
+    
+    return PHEROMONE_LEVEL_TO_FLOAT(TILE_PHEROMONE(tile, channel)[TILE_CELL_INDEX(x, y)]);
+}
+
+static void build_tile_gradients(const World* world, WorldTile* tile, int tile_x, int tile_y,
+                                 const PheromoneKernels* kernels) {
+    float levels[LEVEL_STRIDE * LEVEL_STRIDE];
+    uint8_t walkable[LEVEL_STRIDE * LEVEL_STRIDE];
+    int x0 = tile_x << WORLD_TILE_SHIFT;
+    int y0 = tile_y << WORLD_TILE_SHIFT;
+    int count_x = (world->width - x0 < WORLD_TILE_SIZE) ? world->width - x0 : WORLD_TILE_SIZE;
+    int count_y = (world->height - y0 < WORLD_TILE_SIZE) ? world->height - y0 : WORLD_TILE_SIZE;
+    
+    // Walkability of the tile and its halo; cells outside the world are not
+    for (int y = 0; y < WORLD_TILE_SIZE; y++) {
+        for (int x = 0; x < WORLD_TILE_SIZE; x++) {
+            walkable[(y + 1) * LEVEL_STRIDE + x + 1] =
+                x < count_x && y < count_y && TERRAIN_WALKABLE(tile->terrain[(y << WORLD_TILE_SHIFT) + x]);
         }
-    } else if (type == PHEROMONE_TYPE_HOME) {
-        cell->pheromone_home += amount;
-        if (cell->pheromone_home > PHEROMONE_MAX) {
-            cell->pheromone_home = PHEROMONE_MAX;
+    }
+    for (int i = -1; i <= WORLD_TILE_SIZE; i++) {
+        walkable[i + 1] = (uint8_t)is_walkable(world, x0 + i, y0 - 1);
+        walkable[(WORLD_TILE_SIZE + 1) * LEVEL_STRIDE + i + 1] = (uint8_t)is_walkable(world, x0 + i, y0 + WORLD_TILE_SIZE);
+        walkable[(i + 1) * LEVEL_STRIDE] = (uint8_t)is_walkable(world, x0 - 1, y0 + i);
+        walkable[(i + 1) * LEVEL_STRIDE + WORLD_TILE_SIZE + 1] = (uint8_t)is_walkable(world, x0 + WORLD_TILE_SIZE, y0 + i);
+    }
+    
+    // Cells an ant cannot step onto count as empty
+    for (int channel = 0; channel < world->pheromone_channels; channel++) {
+        const PheromoneLevel* plane = TILE_PHEROMONE(tile, channel);
+        for (int y = 0; y < WORLD_TILE_SIZE; y++) {
+            float* row = levels + (y + 1) * LEVEL_STRIDE + 1;
+            const uint8_t* mask = walkable + (y + 1) * LEVEL_STRIDE + 1;
+            for (int x = 0; x < WORLD_TILE_SIZE; x++) {
+                row[x] = mask[x] ? PHEROMONE_LEVEL_TO_FLOAT(plane[(y << WORLD_TILE_SHIFT) + x]) : 0.0f;
+            }
+        }
+        for (int i = -1; i <= WORLD_TILE_SIZE; i++) {
+            int top = i + 1;
+            int bottom = (WORLD_TILE_SIZE + 1) * LEVEL_STRIDE + i + 1;
+            int left = (i + 1) * LEVEL_STRIDE;
+            int right = (i + 1) * LEVEL_STRIDE + WORLD_TILE_SIZE + 1;
+            levels[top] = walkable[top] ? stored_level(world, x0 + i, y0 - 1, channel) : 0.0f;
+            levels[bottom] = walkable[bottom] ? stored_level(world, x0 + i, y0 + WORLD_TILE_SIZE, channel) : 0.0f;
+            levels[left] = walkable[left] ? stored_level(world, x0 - 1, y0 + i, channel) : 0.0f;
+            levels[right] = walkable[right] ? stored_level(world, x0 + WORLD_TILE_SIZE, y0 + i, channel) : 0.0f;
+        }
+        
+        uint8_t* directions = TILE_GRADIENT(tile, channel);
+        for (int y = 0; y < count_y; y++) {
+            const float* mid = levels + (y + 1) * LEVEL_STRIDE + 1;
+            kernels->gradient_row(directions + (y << WORLD_TILE_SHIFT), mid - LEVEL_STRIDE, mid,
+                                  mid + LEVEL_STRIDE, count_x);
         }
     }
 }
 
-void evaporate_pheromones(World* world) {
+static void gradient_band(void* context, int band, int band_count) {
+    PheromoneSweep* sweep = (PheromoneSweep*)context;
+    World* world = sweep->world;
+    int first_row, last_row;
+    band_tile_rows(world, band, band_count, &first_row, &last_row);
+    
+    for (int tile_y = first_row; tile_y < last_row; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            build_tile_gradients(world, tile, tile_x, tile_y, sweep->kernels);
+            tile->gradient_stamp = world->pheromone_version;
+        }
+    }
+}
+
+// Every field pass invalidates the direction planes; the tiles still
+// holding pheromone get new ones when they are enabled
+static void finish_pheromone_pass(World* world, const PheromoneKernels* kernels) {
+    world->pheromone_version++;
+    if (!world->pheromone_gradients) return;
+    
+    PheromoneSweep sweep = { world, kernels, 0 };
+    run_parallel(gradient_band, &sweep, pheromone_band_count(world));
+}
+
+void set_pheromone_gradients(World* world, int enabled) {
     if (world == NULL) return;
     
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            Cell* cell = &world->grid[y][x];
+    // Planes were not kept up to date while disabled
+    world->pheromone_gradients = enabled ? 1 : 0;
+    world->pheromone_version++;
+}
+
+static void evaporate_band(void* context, int band, int band_count) {
+    PheromoneSweep* sweep = (PheromoneSweep*)context;
+    World* world = sweep->world;
+    int first_row, last_row;
+    band_tile_rows(world, band, band_count, &first_row, &last_row);
+    
+    for (int tile_y = first_row; tile_y < last_row; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
             
-            // Evaporate food pheromone
-            cell->pheromone_food *= (1.0f - PHEROMONE_EVAPORATION_RATE);
-            if (cell->pheromone_food < 0.1f) {
-                cell->pheromone_food = 0.0f;
-            }
+            // Every channel of the tile in one contiguous run
+            sweep->kernels->evaporate(TILE_PHEROMONE(tile, 0), tile_level_count(world));
             
-            // Evaporate home pheromone
-            cell->pheromone_home *= (1.0f - PHEROMONE_EVAPORATION_RATE);
-            if (cell->pheromone_home < 0.1f) {
-                cell->pheromone_home = 0.0f;
+            // Fully decayed tiles drop out of later sweeps
+            if (!tile_has_pheromone(world, tile, sweep->kernels)) {
+                set_tile_active(world, tile_x, tile_y, 0);
             }
         }
     }
 }
 
-void diffuse_pheromones(World* world) {
+void evaporate_pheromones(World* world) {
     if (world == NULL) return;
     
-    // Create temporary grid for diffusion calculations
-    float** temp_food = (float**)safe_malloc(world->height * sizeof(float*));
-    float** temp_home = (float**)safe_malloc(world->height * sizeof(float*));
-    
-    if (temp_food == NULL || temp_home == NULL) {
-        // Clean up and return if allocation failed
-        if (temp_food) safe_free(temp_food);
-        if (temp_home) safe_free(temp_home);
+    // Lazy mode: tiles catch up when they are next accessed
+    if (world->lazy_evaporation) {
+        world->pheromone_clock++;
+        world->pheromone_version++;
         return;
     }
     
-    // Allocate rows
-    for (int i = 0; i < world->height; i++) {
-        temp_food[i] = (float*)safe_calloc(world->width, sizeof(float));
-        temp_home[i] = (float*)safe_calloc(world->width, sizeof(float));
+    PheromoneSweep sweep = { world, get_pheromone_kernels(), 1 };
+    run_parallel(evaporate_band, &sweep, pheromone_band_count(world));
+    finish_pheromone_pass(world, sweep.kernels);
+}
+
+// Diffusion stencil in gather form. Each tile is processed from a padded
+// scratch holding, for the tile and a one-cell halo around it, the share
+// every cell hands to each of its neighbours. Output cells only read the
+// scratch and only write their own tile, so the result does not depend on
+// traversal order and the inner loop needs no bounds checks.
+#define SHARE_STRIDE (WORLD_TILE_SIZE + 2)
+
+// Level of a cell after evaporation and the cut-off (scalar form of the
+// kernels' evaporation, used for halo and world border cells)
+static float evaporated_level(float level) {
+    level *= (1.0f - PHEROMONE_EVAPORATION_RATE);
+    return (level < PHEROMONE_CUTOFF) ? 0.0f : level;
+}
+
+// Level a cell spreads from: decayed first when the sweep also evaporates
+static float source_level(float level, int evaporate) {
+    return evaporate ? evaporated_level(level) : level;
+}
+
+// Fraction of a cell handed to each neighbour: the diffusion rate split over
+// the neighbours that exist at (x, y)
+static float diffusion_share_weight(const World* world, int x, int y) {
+    int columns = 1 + (x > 0) + (x < world->width - 1);
+    int rows = 1 + (y > 0) + (y < world->height - 1);
+    int neighbor_count = columns * rows - 1;
+    return (neighbor_count > 0) ? PHEROMONE_DIFFUSION_RATE / neighbor_count : 0.0f;
+}
+
+// Share handed out by the cell at (x, y), 0 outside the world
+static float diffusion_share(const World* world, int x, int y, int channel, int evaporate) {
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return 0.0f;
+    
+    return source_level(PHEROMONE_LEVEL_TO_FLOAT(TILE_PHEROMONE(tile, channel)[TILE_CELL_INDEX(x, y)]), evaporate) *
+           diffusion_share_weight(world, x, y);
+}
+
+// Diffusion-only counterparts of the spread and step_row kernels
+static void spread_levels(float* shares, const PheromoneLevel* levels, float weight, int count) {
+    for (int x = 0; x < count; x++) {
+        shares[x] = PHEROMONE_LEVEL_TO_FLOAT(levels[x]) * weight;
+    }
+}
+
+static void diffuse_row(PheromoneLevel* out, const PheromoneLevel* levels, const float* up,
+                        const float* mid, const float* down, int count) {
+    for (int x = 0; x < count; x++) {
+        float level = PHEROMONE_LEVEL_TO_FLOAT(levels[x]) * (1.0f - PHEROMONE_DIFFUSION_RATE)
+                    + up[x - 1] + up[x] + up[x + 1]
+                    + mid[x - 1] + mid[x + 1]
+                    + down[x - 1] + down[x] + down[x + 1];
+        out[x] = PHEROMONE_LEVEL_FROM_FLOAT((level > PHEROMONE_MAX) ? PHEROMONE_MAX : level);
+    }
+}
+
+// Fill the padded share scratch for one tile
+static void gather_tile_shares(const World* world, const WorldTile* tile, int x0, int y0,
+                               int channel, float* shares, const PheromoneSweep* sweep) {
+    const PheromoneLevel* plane = TILE_PHEROMONE(tile, channel);
+    int count_x = (world->width - x0 < WORLD_TILE_SIZE) ? world->width - x0 : WORLD_TILE_SIZE;
+    int count_y = (world->height - y0 < WORLD_TILE_SIZE) ? world->height - y0 : WORLD_TILE_SIZE;
+    int on_border = (x0 == 0 || y0 == 0 ||
+                     x0 + WORLD_TILE_SIZE >= world->width || y0 + WORLD_TILE_SIZE >= world->height);
+    
+    // Tile cells; away from the world border every cell has 8 neighbours
+    for (int y = 0; y < WORLD_TILE_SIZE; y++) {
+        float* row = shares + (y + 1) * SHARE_STRIDE + 1;
+        const PheromoneLevel* levels = plane + (y << WORLD_TILE_SHIFT);
         
-        if (temp_food[i] == NULL || temp_home[i] == NULL) {
-            // Clean up and return if allocation failed
-            for (int j = 0; j < i; j++) {
-                safe_free(temp_food[j]);
-                safe_free(temp_home[j]);
+        if (!on_border) {
+            if (sweep->evaporate) {
+                sweep->kernels->spread(row, levels, PHEROMONE_DIFFUSION_RATE / 8, WORLD_TILE_SIZE);
+            } else {
+                spread_levels(row, levels, PHEROMONE_DIFFUSION_RATE / 8, WORLD_TILE_SIZE);
+            }
+        } else {
+            // Cells past the world edge hand out nothing
+            int valid_x = (y < count_y) ? count_x : 0;
+            for (int x = 0; x < valid_x; x++) {
+                row[x] = source_level(PHEROMONE_LEVEL_TO_FLOAT(levels[x]), sweep->evaporate) *
+                         diffusion_share_weight(world, x0 + x, y0 + y);
+            }
+            for (int x = valid_x; x < WORLD_TILE_SIZE; x++) {
+                row[x] = 0.0f;
             }
-            safe_free(temp_food);
-            safe_free(temp_home);
-            return;
         }
     }
     
-    // Copy current pheromone levels to temp grid
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            temp_food[y][x] = world->grid[y][x].pheromone_food;
-            temp_home[y][x] = world->grid[y][x].pheromone_home;
-        }
+    // Halo ring from the neighbouring tiles
+    for (int x = -1; x <= WORLD_TILE_SIZE; x++) {
+        shares[x + 1] = diffusion_share(world, x0 + x, y0 - 1, channel, sweep->evaporate);
+        shares[(WORLD_TILE_SIZE + 1) * SHARE_STRIDE + x + 1] =
+            diffusion_share(world, x0 + x, y0 + WORLD_TILE_SIZE, channel, sweep->evaporate);
+    }
+    for (int y = 0; y < WORLD_TILE_SIZE; y++) {
+        shares[(y + 1) * SHARE_STRIDE] = diffusion_share(world, x0 - 1, y0 + y, channel, sweep->evaporate);
+        shares[(y + 1) * SHARE_STRIDE + WORLD_TILE_SIZE + 1] =
+            diffusion_share(world, x0 + WORLD_TILE_SIZE, y0 + y, channel, sweep->evaporate);
     }
+}
+
+// Advance one tile: read the front buffers, write the back buffers
+// Each output cell keeps the level it does not hand out and collects the
+// shares of its 8 neighbours.
+static void step_tile(const World* world, WorldTile* tile, int tile_x, int tile_y,
+                      const PheromoneSweep* sweep) {
+    float shares[SHARE_STRIDE * SHARE_STRIDE];
+    int x0 = tile_x << WORLD_TILE_SHIFT;
+    int y0 = tile_y << WORLD_TILE_SHIFT;
+    int count_x = (world->width - x0 < WORLD_TILE_SIZE) ? world->width - x0 : WORLD_TILE_SIZE;
+    int count_y = (world->height - y0 < WORLD_TILE_SIZE) ? world->height - y0 : WORLD_TILE_SIZE;
     
-    // Calculate diffusion
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            float food_diffusion = 0.0f;
-            float home_diffusion = 0.0f;
-            int neighbor_count = 0;
+    // All channels of the tile in one visit
+    for (int channel = 0; channel < world->pheromone_channels; channel++) {
+        gather_tile_shares(world, tile, x0, y0, channel, shares, sweep);
+        
+        const PheromoneLevel* levels = TILE_PHEROMONE(tile, channel);
+        PheromoneLevel* out = TILE_PHEROMONE_BACK(tile, channel);
+        
+        // Cells outside the world are never written and stay empty
+        for (int y = 0; y < count_y; y++) {
+            const float* up = shares + y * SHARE_STRIDE + 1;
+            const float* mid = shares + (y + 1) * SHARE_STRIDE + 1;
+            const float* down = shares + (y + 2) * SHARE_STRIDE + 1;
+            
+            if (sweep->evaporate) {
+                sweep->kernels->step_row(out + (y << WORLD_TILE_SHIFT), levels + (y << WORLD_TILE_SHIFT),
+                                         up, mid, down, count_x);
+            } else {
+                diffuse_row(out + (y << WORLD_TILE_SHIFT), levels + (y << WORLD_TILE_SHIFT),
+                            up, mid, down, count_x);
+            }
+        }
+    }
+}
+
+// Activate (allocating if needed) the tiles next to every active tile with
+// pheromone within `reach` cells of its border, the distance it can spread
+// before the next sweep, so the stencil has somewhere to spread into
+static void grow_pheromone_tiles(World* world, int reach) {
+    for (int tile_y = 0; tile_y < world->tiles_y; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            const WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            int top = 0, bottom = 0, left = 0, right = 0;
+            for (int channel = 0; channel < world->pheromone_channels; channel++) {
+                const PheromoneLevel* plane = TILE_PHEROMONE(tile, channel);
+                for (int d = 0; d < reach; d++) {
+                    for (int i = 0; i < WORLD_TILE_SIZE; i++) {
+                        top |= plane[d * WORLD_TILE_SIZE + i] > 0;
+                        bottom |= plane[(WORLD_TILE_SIZE - 1 - d) * WORLD_TILE_SIZE + i] > 0;
+                        left |= plane[i * WORLD_TILE_SIZE + d] > 0;
+                        right |= plane[i * WORLD_TILE_SIZE + WORLD_TILE_SIZE - 1 - d] > 0;
+                    }
+                }
+            }
             
-            // Check 8 neighbors
             for (int dy = -1; dy <= 1; dy++) {
                 for (int dx = -1; dx <= 1; dx++) {
-                    if (dx == 0 && dy == 0) continue; // Skip center cell
+                    if (dx == 0 && dy == 0) continue;
+                    if ((dy < 0 && !top) || (dy > 0 && !bottom)) continue;
+                    if ((dx < 0 && !left) || (dx > 0 && !right)) continue;
                     
-                    int nx = x + dx;
-                    int ny = y + dy;
-                    
-                    if (is_valid_position(world, nx, ny)) {
-                        neighbor_count++;
-                        food_diffusion += temp_food[ny][nx];
-                        home_diffusion += temp_home[ny][nx];
+                    if (get_or_create_tile(world, (tile_x + dx) << WORLD_TILE_SHIFT,
+                                           (tile_y + dy) << WORLD_TILE_SHIFT) != NULL) {
+                        set_tile_active(world, tile_x + dx, tile_y + dy, 1);
                     }
                 }
             }
+        }
+    }
+}
+
+static void step_band(void* context, int band, int band_count) {
+    PheromoneSweep* sweep = (PheromoneSweep*)context;
+    World* world = sweep->world;
+    int first_row, last_row;
+    band_tile_rows(world, band, band_count, &first_row, &last_row);
+    
+    // Halo rows come from the neighbouring bands' front buffers. Inactive
+    // neighbours hold no pheromone, so skipping them loses nothing.
+    for (int tile_y = first_row; tile_y < last_row; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
             
-            // Apply diffusion if we have neighbors
-            if (neighbor_count > 0) {
-                float food_transfer = temp_food[y][x] * PHEROMONE_DIFFUSION_RATE / neighbor_count;
-                float home_transfer = temp_home[y][x] * PHEROMONE_DIFFUSION_RATE / neighbor_count;
-                
-                // Transfer to neighbors
-                for (int dy = -1; dy <= 1; dy++) {
-                    for (int dx = -1; dx <= 1; dx++) {
-                        if (dx == 0 && dy == 0) continue;
-                        
-                        int nx = x + dx;
-                        int ny = y + dy;
-                        
-                        if (is_valid_position(world, nx, ny)) {
-                            world->grid[ny][nx].pheromone_food += food_transfer;
-                            world->grid[ny][nx].pheromone_home += home_transfer;
-                            
-                            // Cap at maximum
-                            if (world->grid[ny][nx].pheromone_food > PHEROMONE_MAX) {
-                                world->grid[ny][nx].pheromone_food = PHEROMONE_MAX;
-                            }
-                            if (world->grid[ny][nx].pheromone_home > PHEROMONE_MAX) {
-                                world->grid[ny][nx].pheromone_home = PHEROMONE_MAX;
-                            }
-                        }
-                    }
-                }
-                
-                // Remove transferred amount from source
-                world->grid[y][x].pheromone_food -= food_transfer * neighbor_count;
-                world->grid[y][x].pheromone_home -= home_transfer * neighbor_count;
-                
-                // Ensure we don't go below 0
-                if (world->grid[y][x].pheromone_food < 0.0f) {
-                    world->grid[y][x].pheromone_food = 0.0f;
-                }
-                if (world->grid[y][x].pheromone_home < 0.0f) {
-                    world->grid[y][x].pheromone_home = 0.0f;
-                }
+            step_tile(world, tile, tile_x, tile_y, sweep);
+        }
+    }
+}
+
+// Flip the stepped tiles to their new levels; tiles that came out empty
+// drop out of later sweeps
+static void publish_band(void* context, int band, int band_count) {
+    PheromoneSweep* sweep = (PheromoneSweep*)context;
+    World* world = sweep->world;
+    int first_row, last_row;
+    band_tile_rows(world, band, band_count, &first_row, &last_row);
+    
+    for (int tile_y = first_row; tile_y < last_row; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            tile->front ^= 1;
+            if (!tile_has_pheromone(world, tile, sweep->kernels)) {
+                set_tile_active(world, tile_x, tile_y, 0);
             }
         }
     }
+}
+
+// Run one stencil sweep over every tile and publish the new levels
+static void sweep_pheromone_field(World* world, int evaporate) {
+    settle_pheromone_decay(world);
+    
+    // Tile allocation touches the shared directory, keep it serial
+    grow_pheromone_tiles(world, 1);
+    
+    PheromoneSweep sweep = { world, get_pheromone_kernels(), evaporate };
+    run_parallel(step_band, &sweep, pheromone_band_count(world));
+    run_parallel(publish_band, &sweep, pheromone_band_count(world));
+    finish_pheromone_pass(world, sweep.kernels);
+}
+
+void diffuse_pheromones(World* world) {
+    if (world == NULL) return;
     
-    // Clean up temporary arrays
-    for (int i = 0; i < world->height; i++) {
-        safe_free(temp_food[i]);
-        safe_free(temp_home[i]);
+    sweep_pheromone_field(world, 0);
+}
+
+// Fused evaporation + diffusion: one pass instead of two
+void step_pheromone_field(World* world) {
+    if (world == NULL) return;
+    
+    sweep_pheromone_field(world, 1);
+}
+
+// Temporal blocking. A block advances each tile `steps` fused steps in one
+// visit instead of streaming the whole field through memory once per step.
+// The tile and a halo `steps` cells wide are copied from the front buffers
+// into a local window; each sub-step updates a region that shrinks by one
+// cell per side, so after the last one the tile's own cells are exact.
+// Sub-steps use the same kernels, weights and storage rounding as a sweep,
+// so a block of k steps matches k calls to step_pheromone_field.
+#define BLOCK_STRIDE (WORLD_TILE_SIZE + 2 * MAX_PHEROMONE_BLOCK_STEPS)
+
+typedef struct {
+    PheromoneLevel levels[2][BLOCK_STRIDE * BLOCK_STRIDE];
+    float shares[BLOCK_STRIDE * BLOCK_STRIDE];
+} PheromoneWindow;
+
+// Copy one channel of the tile at (x0, y0) and its halo into the window;
+// cells outside the world or in unallocated tiles are empty
+static void load_block_window(const World* world, int x0, int y0, int channel, int steps,
+                              int stride, PheromoneLevel* window) {
+    for (int row = 0; row < stride; row++) {
+        PheromoneLevel* out = window + row * stride;
+        int y = y0 - steps + row;
+        
+        // Left halo, the tile's own row and right halo come from three tiles
+        int x = x0 - steps;
+        while (x < x0 + WORLD_TILE_SIZE + steps) {
+            int run_end = (x < x0) ? x0 : (x < x0 + WORLD_TILE_SIZE) ? x0 + WORLD_TILE_SIZE
+                                                                      : x0 + WORLD_TILE_SIZE + steps;
+            const WorldTile* tile = get_tile(world, x, y);
+            if (tile != NULL) {
+                memcpy(out, TILE_PHEROMONE(tile, channel) + TILE_CELL_INDEX(x, y),
+                       (size_t)(run_end - x) * sizeof(PheromoneLevel));
+            } else {
+                memset(out, 0, (size_t)(run_end - x) * sizeof(PheromoneLevel));
+            }
+            out += run_end - x;
+            x = run_end;
+        }
     }
-    safe_free(temp_food);
-    safe_free(temp_home);
 }
 
-// Pheromone queries
-float get_pheromone_intensity(const World* world, int x, int y, int type) {
-    if (!is_valid_position(world, x, y)) return 0.0f;
+// Shares handed out by count window cells starting at world cell (x, y);
+// the same weights gather_tile_shares uses
+static void spread_block_row(const World* world, const PheromoneKernels* kernels, float* shares,
+                             const PheromoneLevel* levels, int x, int y, int count) {
+    // Window columns inside the world, and those with all 8 neighbours
+    int first = clamp_int(-x, 0, count);
+    int last = clamp_int(world->width - x, 0, count);
+    int inner_first = first, inner_last = first;
+    if (y > 0 && y < world->height - 1) {
+        inner_first = clamp_int(1 - x, first, last);
+        inner_last = clamp_int(world->width - 1 - x, inner_first, last);
+    }
+    if (y < 0 || y >= world->height) {
+        first = last = inner_first = inner_last = 0;
+    }
+    
+    for (int i = 0; i < first; i++) {
+        shares[i] = 0.0f;
+    }
+    for (int i = first; i < inner_first; i++) {
+        shares[i] = evaporated_level(PHEROMONE_LEVEL_TO_FLOAT(levels[i])) * diffusion_share_weight(world, x + i, y);
+    }
+    kernels->spread(shares + inner_first, levels + inner_first, PHEROMONE_DIFFUSION_RATE / 8,
+                    inner_last - inner_first);
+    for (int i = inner_last; i < last; i++) {
+        shares[i] = evaporated_level(PHEROMONE_LEVEL_TO_FLOAT(levels[i])) * diffusion_share_weight(world, x + i, y);
+    }
+    for (int i = last; i < count; i++) {
+        shares[i] = 0.0f;
+    }
+}
+
+// Advance one tile `steps` fused steps, writing its back buffers
+static void step_tile_block(const World* world, WorldTile* tile, int tile_x, int tile_y, int steps,
+                            const PheromoneKernels* kernels, PheromoneWindow* window) {
+    int stride = WORLD_TILE_SIZE + 2 * steps;
+    int x0 = tile_x << WORLD_TILE_SHIFT;
+    int y0 = tile_y << WORLD_TILE_SHIFT;
+    
+    for (int channel = 0; channel < world->pheromone_channels; channel++) {
+        load_block_window(world, x0, y0, channel, steps, stride, window->levels[0]);
+        
+        // Sub-step s reads window cells `steps - s + 1` cells into the halo
+        // and writes cells `steps - s` cells into it
+        int current = 0;
+        for (int s = 1; s <= steps; s++) {
+            const PheromoneLevel* levels = window->levels[current];
+            PheromoneLevel* out = window->levels[current ^ 1];
+            
+            for (int row = s - 1; row < stride - s + 1; row++) {
+                spread_block_row(world, kernels, window->shares + row * stride + s - 1,
+                                 levels + row * stride + s - 1,
+                                 x0 - steps + s - 1, y0 - steps + row, stride - 2 * (s - 1));
+            }
+            
+            // Only cells inside the world are stepped; the rest stay empty
+            int first_x = clamp_int(steps - x0, s, stride - s);
+            int last_x = clamp_int(world->width - x0 + steps, first_x, stride - s);
+            int first_y = clamp_int(steps - y0, s, stride - s);
+            int last_y = clamp_int(world->height - y0 + steps, first_y, stride - s);
+            for (int row = first_y; row < last_y; row++) {
+                const float* mid = window->shares + row * stride + first_x;
+                kernels->step_row(out + row * stride + first_x, levels + row * stride + first_x,
+                                  mid - stride, mid, mid + stride, last_x - first_x);
+            }
+            current ^= 1;
+        }
+        
+        // The tile's own cells are exact after the last sub-step
+        const PheromoneLevel* levels = window->levels[current];
+        PheromoneLevel* back = TILE_PHEROMONE_BACK(tile, channel);
+        int count_x = (world->width - x0 < WORLD_TILE_SIZE) ? world->width - x0 : WORLD_TILE_SIZE;
+        int count_y = (world->height - y0 < WORLD_TILE_SIZE) ? world->height - y0 : WORLD_TILE_SIZE;
+        for (int y = 0; y < count_y; y++) {
+            memcpy(back + (y << WORLD_TILE_SHIFT), levels + (y + steps) * stride + steps,
+                   (size_t)count_x * sizeof(PheromoneLevel));
+        }
+    }
+}
+
+typedef struct {
+    World* world;
+    const PheromoneKernels* kernels;
+    int steps;
+} PheromoneBlockSweep;
+
+static void step_block_band(void* context, int band, int band_count) {
+    PheromoneBlockSweep* sweep = (PheromoneBlockSweep*)context;
+    World* world = sweep->world;
+    int first_row, last_row;
+    band_tile_rows(world, band, band_count, &first_row, &last_row);
     
-    Cell* cell = &world->grid[y][x];
+    PheromoneWindow window;
+    for (int tile_y = first_row; tile_y < last_row; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            step_tile_block(world, tile, tile_x, tile_y, sweep->steps, sweep->kernels, &window);
+        }
+    }
+}
+
+void advance_pheromone_field(World* world, int steps) {
+    if (world == NULL) return;
     
-    switch (type) {
-        case PHEROMONE_TYPE_FOOD:
-            return cell->pheromone_food;
-        case PHEROMONE_TYPE_HOME:
-            return cell->pheromone_home;
-        default:
-            return 0.0f;
+    while (steps > 0) {
+        int block = (steps < MAX_PHEROMONE_BLOCK_STEPS) ? steps : MAX_PHEROMONE_BLOCK_STEPS;
+        steps -= block;
+        if (block == 1) {
+            sweep_pheromone_field(world, 1);
+            continue;
+        }
+        
+        settle_pheromone_decay(world);
+        grow_pheromone_tiles(world, block);
+        
+        PheromoneBlockSweep block_sweep = { world, get_pheromone_kernels(), block };
+        PheromoneSweep sweep = { world, block_sweep.kernels, 1 };
+        run_parallel(step_block_band, &block_sweep, pheromone_band_count(world));
+        run_parallel(publish_band, &sweep, pheromone_band_count(world));
+        finish_pheromone_pass(world, sweep.kernels);
     }
 }
 
-float get_max_pheromone_neighbor(const World* world, int x, int y, int type) {
+void set_pheromone_block_steps(World* world, int steps) {
+    if (world == NULL) return;
+    
+    flush_pheromone_steps(world);
+    world->pheromone_block_steps = clamp_int(steps, 1, MAX_PHEROMONE_BLOCK_STEPS);
+}
+
+// Deposits made while steps are queued land in the current levels, so the
+// block ages them from its first step: a deposit made j steps into a block
+// of k decays and spreads for all k steps rather than the remaining k - j.
+void queue_pheromone_step(World* world) {
+    if (world == NULL) return;
+    
+    if (++world->pheromone_pending_steps >= world->pheromone_block_steps) {
+        flush_pheromone_steps(world);
+    }
+}
+
+void flush_pheromone_steps(World* world) {
+    if (world == NULL) return;
+    
+    int steps = world->pheromone_pending_steps;
+    world->pheromone_pending_steps = 0;
+    advance_pheromone_field(world, steps);
+}
+
+// Pheromone queries
+float get_pheromone_intensity(const World* world, int x, int y, int colony_id, int type) {
+    if (world == NULL) return 0.0f;
+    int channel = pheromone_channel(world, colony_id, type);
+    if (channel < 0) return 0.0f;
+    
+    WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return 0.0f;
+    
+    return get_tile_pheromone(world, tile, channel, TILE_CELL_INDEX(x, y));
+}
+
+// Current level of one tile cell, decayed to the clock in lazy mode
+float get_tile_pheromone(const World* world, const WorldTile* tile, int channel, int index) {
+    float level = PHEROMONE_LEVEL_TO_FLOAT(TILE_PHEROMONE(tile, channel)[index]);
+    if (!world->lazy_evaporation) return level;
+    
+    return decayed_level(level, world->pheromone_clock - tile->decay_stamp);
+}
+
+int get_pheromone_gradient(const World* world, int x, int y, int colony_id, int type) {
+    if (world == NULL || !world->pheromone_gradients) return PHEROMONE_GRADIENT_UNKNOWN;
+    int channel = pheromone_channel(world, colony_id, type);
+    if (channel < 0) return PHEROMONE_GRADIENT_UNKNOWN;
+    
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL || tile->gradient_stamp != world->pheromone_version) return PHEROMONE_GRADIENT_UNKNOWN;
+    
+    uint8_t direction = TILE_GRADIENT(tile, channel)[TILE_CELL_INDEX(x, y)];
+    if (direction == GRADIENT_STALE) return PHEROMONE_GRADIENT_UNKNOWN;
+    return (direction == GRADIENT_NONE) ? -1 : direction;
+}
+
+float get_max_pheromone_neighbor(const World* world, int x, int y, int colony_id, int type) {
     if (!is_valid_position(world, x, y)) return 0.0f;
     
     float max_pheromone = 0.0f;
@@ -220,7 +798,7 @@ float get_max_pheromone_neighbor(const World* world, int x, int y, int type) {
             int ny = y + dy;
             
             if (is_valid_position(world, nx, ny)) {
-                float pheromone = get_pheromone_intensity(world, nx, ny, type);
+                float pheromone = get_pheromone_intensity(world, nx, ny, colony_id, type);
                 if (pheromone > max_pheromone) {
                     max_pheromone = pheromone;
                 }
@@ -235,12 +813,22 @@ float get_max_pheromone_neighbor(const World* world, int x, int y, int type) {
 void reset_pheromones(World* world) {
     if (world == NULL) return;
     
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            world->grid[y][x].pheromone_food = PHEROMONE_INITIAL;
-            world->grid[y][x].pheromone_home = PHEROMONE_INITIAL;
+    size_t tile_count = (size_t)world->tiles_x * (size_t)world->tiles_y;
+    for (size_t t = 0; t < tile_count; t++) {
+        WorldTile* tile = world->tiles[t];
+        if (tile == NULL) continue;
+        
+        PheromoneLevel* levels = TILE_PHEROMONE(tile, 0);
+        int count = tile_level_count(world);
+        for (int i = 0; i < count; i++) {
+            levels[i] = PHEROMONE_LEVEL_FROM_FLOAT(PHEROMONE_INITIAL);
         }
+        tile->decay_stamp = world->pheromone_clock;
     }
+    world->pheromone_pending_steps = 0;
+    world->pheromone_version++;
+    memset(world->active_tiles, 0,
+           (size_t)world->active_row_words * (size_t)world->tiles_y * sizeof(uint64_t));
     
     print_info("All pheromones reset");
 }
@@ -248,40 +836,42 @@ void reset_pheromones(World* world) {
 void normalize_pheromones(World* world) {
     if (world == NULL) return;
     
-    float max_food = 0.0f;
-    float max_home = 0.0f;
+    settle_pheromone_decay(world);
+    
+    // Every colony's food and home channels are scaled independently
+    const PheromoneKernels* kernels = get_pheromone_kernels();
+    float* max_levels = (float*)safe_calloc(world->pheromone_channels, sizeof(float));
+    if (max_levels == NULL) return;
     
     // Find maximum values
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            if (world->grid[y][x].pheromone_food > max_food) {
-                max_food = world->grid[y][x].pheromone_food;
-            }
-            if (world->grid[y][x].pheromone_home > max_home) {
-                max_home = world->grid[y][x].pheromone_home;
+    for (int tile_y = 0; tile_y < world->tiles_y; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            const WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            for (int channel = 0; channel < world->pheromone_channels; channel++) {
+                max_levels[channel] = kernels->find_max(TILE_PHEROMONE(tile, channel), WORLD_TILE_CELLS,
+                                                        max_levels[channel]);
             }
         }
     }
     
     // Normalize if maximum is greater than 0
-    if (max_food > 0.0f) {
-        for (int y = 0; y < world->height; y++) {
-            for (int x = 0; x < world->width; x++) {
-                world->grid[y][x].pheromone_food = 
-                    (world->grid[y][x].pheromone_food / max_food) * PHEROMONE_MAX;
-            }
-        }
-    }
-    
-    if (max_home > 0.0f) {
-        for (int y = 0; y < world->height; y++) {
-            for (int x = 0; x < world->width; x++) {
-                world->grid[y][x].pheromone_home = 
-                    (world->grid[y][x].pheromone_home / max_home) * PHEROMONE_MAX;
+    for (int tile_y = 0; tile_y < world->tiles_y; tile_y++) {
+        for (int tile_x = next_active_tile(world, tile_y, 0); tile_x >= 0;
+             tile_x = next_active_tile(world, tile_y, tile_x + 1)) {
+            WorldTile* tile = world->tiles[(size_t)tile_y * world->tiles_x + tile_x];
+            
+            for (int channel = 0; channel < world->pheromone_channels; channel++) {
+                if (max_levels[channel] > 0.0f) {
+                    kernels->scale(TILE_PHEROMONE(tile, channel), WORLD_TILE_CELLS, max_levels[channel]);
+                }
             }
         }
     }
     
+    safe_free(max_levels);
+    finish_pheromone_pass(world, kernels);
     print_info("Pheromones normalized");
 }
 
@@ -290,6 +880,43 @@ float calculate_pheromone_strength(float base_strength, float distance) {
     return base_strength * expf(-distance * 0.1f);
 }
 
+// Decay check
+static int fade_pheromone_field(int block_steps) {
+    World* world = create_world(4 * WORLD_TILE_SIZE, 4 * WORLD_TILE_SIZE, 1);
+    if (world == NULL) return 1;
+    
+    // A full trail across a tile edge, an isolated cell, and a row holding
+    // each of the lowest stored levels
+    for (int x = WORLD_TILE_SIZE / 2; x < 3 * WORLD_TILE_SIZE; x++) {
+        deposit_pheromone_at_position(world, x, WORLD_TILE_SIZE, 0, PHEROMONE_TYPE_FOOD, PHEROMONE_MAX);
+    }
+    deposit_pheromone_at_position(world, 10, 3 * WORLD_TILE_SIZE, 0, PHEROMONE_TYPE_HOME, PHEROMONE_MAX);
+    for (int n = 1; n <= 2 * WORLD_TILE_SIZE; n++) {
+        float level = (float)n * PHEROMONE_CUTOFF / 4.0f;
+        deposit_pheromone_at_position(world, n, 2 * WORLD_TILE_SIZE + 20, 0, PHEROMONE_TYPE_HOME, level);
+    }
+    
+    int steps = 0;
+    while (count_active_tiles(world) > 0 && steps < PHEROMONE_DECAY_CHECK_STEPS) {
+        advance_pheromone_field(world, block_steps);
+        steps += block_steps;
+    }
+    
+    int remaining = count_active_tiles(world);
+    if (remaining > 0) {
+        print_error("Pheromone field (blocks of %d) still has %d active tiles after %d steps",
+                    block_steps, remaining, steps);
+    } else {
+        print_info("Pheromone field (blocks of %d) faded in %d steps", block_steps, steps);
+    }
+    destroy_world(world);
+    return remaining > 0 ? 1 : 0;
+}
+
+int check_pheromone_decay(void) {
+    return fade_pheromone_field(1) + fade_pheromone_field(MAX_PHEROMONE_BLOCK_STEPS);
+}
+
 // Pheromone visualization helpers
 char get_pheromone_symbol(float intensity) {
     if (intensity <= 0.0f) return ' ';
@@ -4,14 +4,36 @@
 #include "data_structures.h"
 
 // Pheromone deposit and evaporation
-void deposit_pheromone(World* world, Ant* ant);
-void deposit_pheromone_at_position(World* world, int x, int y, int type, float amount);
+void deposit_pheromone(World* world, const Colony* colony, int index);
+void deposit_pheromone_at_position(World* world, int x, int y, int colony_id, int type, float amount);
 void evaporate_pheromones(World* world);
 void diffuse_pheromones(World* world);
+void step_pheromone_field(World* world);  // Fused evaporate + diffuse in one sweep
+void advance_pheromone_field(World* world, int steps);  // `steps` fused steps, temporally blocked
 
-// Pheromone queries
-float get_pheromone_intensity(const World* world, int x, int y, int type);
-float get_max_pheromone_neighbor(const World* world, int x, int y, int type);
+// Temporal blocking: queued steps run as one block (see World.pheromone_block_steps)
+void set_pheromone_block_steps(World* world, int steps);
+void queue_pheromone_step(World* world);
+void flush_pheromone_steps(World* world);
+
+// Precomputed gradient directions (see get_pheromone_gradient)
+void set_pheromone_gradients(World* world, int enabled);
+
+// Lazy evaporation (decay applied on access, see World.pheromone_clock)
+void set_lazy_evaporation(World* world, int enabled);
+void settle_pheromone_decay(World* world);
+
+// Pheromone queries (each colony lays and follows its own trails)
+float get_pheromone_intensity(const World* world, int x, int y, int colony_id, int type);
+float get_tile_pheromone(const World* world, const WorldTile* tile, int channel, int index);
+float get_max_pheromone_neighbor(const World* world, int x, int y, int colony_id, int type);
+
+// Direction (0-7) to the strongest walkable neighbouring trail, -1 when no
+// neighbour holds any, or PHEROMONE_GRADIENT_UNKNOWN when the direction
+// planes have no current entry for the cell
+int get_pheromone_gradient(const World* world, int x, int y, int colony_id, int type);
+#define PHEROMONE_GRADIENT_UNKNOWN (-2)
+void set_pheromone_intensity(World* world, int x, int y, int colony_id, int type, float intensity);
 
 // Pheromone type constants
 #define PHEROMONE_TYPE_FOOD 0
@@ -22,6 +44,11 @@ void reset_pheromones(World* world);
 void normalize_pheromones(World* world);
 float calculate_pheromone_strength(float base_strength, float distance);
 
+// Leave a field of trails alone, swept step by step and in blocks, and
+// check it fades to zero and deactivates every tile; returns the number
+// of failures
+int check_pheromone_decay(void);
+
 // Pheromone visualization helpers
 char get_pheromone_symbol(float intensity);
 int get_pheromone_color(float intensity);
@@ -0,0 +1,98 @@
+#include "slab_pool.h"
+#include "config.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Each slab starts with a link to the previous slab, padded to a cache line
+// so the objects after it start on one too
+#define SLAB_HEADER_SIZE GRID_ALIGNMENT
+
+static size_t slab_size(const SlabPool* pool) {
+    return SLAB_HEADER_SIZE + pool->object_size * (size_t)pool->objects_per_slab;
+}
+
+// Pool lifecycle
+void init_slab_pool(SlabPool* pool, size_t object_size, int objects_per_slab) {
+    if (pool == NULL) return;
+    
+    // Whole cache lines per object, so no two objects share a line; free
+    // objects hold the free-list link
+    object_size = SLAB_OBJECT_SIZE(object_size);
+    
+    memset(pool, 0, sizeof(SlabPool));
+    pool->object_size = object_size;
+    pool->objects_per_slab = (objects_per_slab > 0) ? objects_per_slab : 1;
+}
+
+void release_slab_pool(SlabPool* pool) {
+    if (pool == NULL) return;
+    
+    void* slab = pool->slabs;
+    while (slab != NULL) {
+        void* previous = *(void**)slab;
+        safe_aligned_free(slab);
+        slab = previous;
+    }
+    
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->slab_count = 0;
+    pool->in_use = 0;
+    pool->peak_in_use = 0;
+}
+
+// Carve a new slab into objects and push them all onto the free list
+static int grow_slab_pool(SlabPool* pool) {
+    char* slab = (char*)safe_aligned_calloc(1, slab_size(pool), GRID_ALIGNMENT);
+    if (slab == NULL) return 0;
+    
+    *(void**)slab = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+    
+    // Link in reverse so objects are handed out in address order
+    char* objects = slab + SLAB_HEADER_SIZE;
+    for (int i = pool->objects_per_slab - 1; i >= 0; i--) {
+        void* object = objects + (size_t)i * pool->object_size;
+        *(void**)object = pool->free_list;
+        pool->free_list = object;
+    }
+    return 1;
+}
+
+// Object allocation
+void* slab_alloc(SlabPool* pool) {
+    if (pool == NULL || pool->object_size == 0) return NULL;
+    
+    if (pool->free_list == NULL && !grow_slab_pool(pool)) {
+        return NULL;
+    }
+    
+    void* object = pool->free_list;
+    pool->free_list = *(void**)object;
+    if (++pool->in_use > pool->peak_in_use) {
+        pool->peak_in_use = pool->in_use;
+    }
+    return object;
+}
+
+void slab_free(SlabPool* pool, void* object) {
+    if (pool == NULL || object == NULL) return;
+    
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+    pool->in_use--;
+}
+
+// Statistics
+size_t get_slab_pool_bytes(const SlabPool* pool) {
+    if (pool == NULL) return 0;
+    return slab_size(pool) * (size_t)pool->slab_count;
+}
+
+int get_slab_pool_capacity(const SlabPool* pool) {
+    if (pool == NULL) return 0;
+    return pool->objects_per_slab * pool->slab_count;
+}
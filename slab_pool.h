@@ -0,0 +1,23 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include "data_structures.h"
+
+// Space an object of the given size takes in a slab: rounded up to whole
+// cache lines, so every object starts on its own line
+#define SLAB_OBJECT_SIZE(size) (((size_t)(size) + GRID_ALIGNMENT - 1) & ~((size_t)GRID_ALIGNMENT - 1))
+
+// Pool lifecycle. Releasing frees whole slabs, so objects still allocated
+// need no individual cleanup; the pool can be reused afterwards.
+void init_slab_pool(SlabPool* pool, size_t object_size, int objects_per_slab);
+void release_slab_pool(SlabPool* pool);
+
+// Object allocation (contents of a new object are undefined)
+void* slab_alloc(SlabPool* pool);
+void slab_free(SlabPool* pool, void* object);
+
+// Statistics
+size_t get_slab_pool_bytes(const SlabPool* pool);
+int get_slab_pool_capacity(const SlabPool* pool);
+
+#endif // SLAB_POOL_H
@@ -0,0 +1,155 @@
+#include "thread_pool.h"
+#include "config.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <windows.h>
+
+// Pool state. Workers sleep on work_ready until generation changes, then
+// claim bands from next_band until none are left.
+static HANDLE* workers = NULL;
+static int worker_count = 0;
+static int pool_initialized = 0;  // pool_lock and the condition variables are set up
+static CRITICAL_SECTION pool_lock;
+static CONDITION_VARIABLE work_ready;
+static CONDITION_VARIABLE work_done;
+static ParallelTask current_task = NULL;
+static void* current_context = NULL;
+static int current_band_count = 0;
+static volatile LONG next_band = 0;
+static int busy_workers = 0;
+static unsigned int generation = 0;
+static int shutting_down = 0;
+
+// Claim and run bands until the current job is exhausted
+static void run_bands(void) {
+    for (;;) {
+        LONG band = InterlockedIncrement(&next_band) - 1;
+        if (band >= current_band_count) break;
+        current_task(current_context, (int)band, current_band_count);
+    }
+}
+
+static DWORD WINAPI worker_main(LPVOID parameter) {
+    (void)parameter;
+    unsigned int seen_generation = 0;
+
+    EnterCriticalSection(&pool_lock);
+    for (;;) {
+        while (generation == seen_generation && !shutting_down) {
+            SleepConditionVariableCS(&work_ready, &pool_lock, INFINITE);
+        }
+        if (shutting_down) break;
+
+        seen_generation = generation;
+        LeaveCriticalSection(&pool_lock);
+
+        run_bands();
+
+        EnterCriticalSection(&pool_lock);
+        if (--busy_workers == 0) {
+            WakeConditionVariable(&work_done);
+        }
+    }
+    LeaveCriticalSection(&pool_lock);
+    return 0;
+}
+
+// Pool lifecycle
+int init_thread_pool(int thread_count) {
+    shutdown_thread_pool();
+
+    if (thread_count <= 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        thread_count = (int)info.dwNumberOfProcessors;
+    }
+    thread_count = clamp_int(thread_count, 1, MAX_THREAD_COUNT);
+
+    InitializeCriticalSection(&pool_lock);
+    InitializeConditionVariable(&work_ready);
+    InitializeConditionVariable(&work_done);
+    pool_initialized = 1;
+    generation = 0;
+    shutting_down = 0;
+
+    // The calling thread is the first worker
+    worker_count = 0;
+    if (thread_count > 1) {
+        workers = (HANDLE*)safe_calloc(thread_count - 1, sizeof(HANDLE));
+        if (workers == NULL) {
+            print_warning("Running single-threaded");
+            return 1;
+        }
+
+        for (int i = 0; i < thread_count - 1; i++) {
+            workers[i] = CreateThread(NULL, 0, worker_main, NULL, 0, NULL);
+            if (workers[i] == NULL) {
+                print_warning("Failed to start worker thread %d", i + 1);
+                break;
+            }
+            worker_count++;
+        }
+    }
+
+    print_info("Thread pool started with %d thread(s)", worker_count + 1);
+    return worker_count + 1;
+}
+
+void shutdown_thread_pool(void) {
+    if (!pool_initialized) return;
+
+    // A single-threaded pool has no workers to stop, but still owns the lock
+    if (workers != NULL) {
+        EnterCriticalSection(&pool_lock);
+        shutting_down = 1;
+        WakeAllConditionVariable(&work_ready);
+        LeaveCriticalSection(&pool_lock);
+
+        for (int i = 0; i < worker_count; i++) {
+            WaitForSingleObject(workers[i], INFINITE);
+            CloseHandle(workers[i]);
+        }
+
+        safe_free(workers);
+        workers = NULL;
+    }
+
+    worker_count = 0;
+    DeleteCriticalSection(&pool_lock);
+    pool_initialized = 0;
+}
+
+int get_thread_count(void) {
+    return worker_count + 1;
+}
+
+void run_parallel(ParallelTask task, void* context, int band_count) {
+    if (task == NULL || band_count <= 0) return;
+
+    // Nothing to share the work with
+    if (worker_count == 0 || band_count == 1) {
+        for (int band = 0; band < band_count; band++) {
+            task(context, band, band_count);
+        }
+        return;
+    }
+
+    EnterCriticalSection(&pool_lock);
+    current_task = task;
+    current_context = context;
+    current_band_count = band_count;
+    next_band = 0;
+    busy_workers = worker_count;
+    generation++;
+    WakeAllConditionVariable(&work_ready);
+    LeaveCriticalSection(&pool_lock);
+
+    run_bands();
+
+    EnterCriticalSection(&pool_lock);
+    while (busy_workers > 0) {
+        SleepConditionVariableCS(&work_done, &pool_lock, INFINITE);
+    }
+    LeaveCriticalSection(&pool_lock);
+}
@@ -0,0 +1,16 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Work callback: processes band number `band` out of `band_count`
+typedef void (*ParallelTask)(void* context, int band, int band_count);
+
+// Pool lifecycle (thread_count 0 = one thread per processor)
+int init_thread_pool(int thread_count);
+void shutdown_thread_pool(void);
+int get_thread_count(void);
+
+// Run task for bands 0..band_count-1 on the pool and the calling thread;
+// returns once every band has completed
+void run_parallel(ParallelTask task, void* context, int band_count);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,92 @@
+// Offline decoder for the binary ant event traces written by --trace.
+// Usage: trace_decode <trace file> [--csv]
+#include "trace_log.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DECODE_BATCH 4096
+
+static const char* event_name(int type) {
+    switch (type) {
+        case TRACE_EVENT_SPAWN: return "spawn";
+        case TRACE_EVENT_MOVE: return "move";
+        case TRACE_EVENT_PICKUP: return "pickup";
+        case TRACE_EVENT_DELIVERY: return "delivery";
+        case TRACE_EVENT_DEATH: return "death";
+        default: return "unknown";
+    }
+}
+
+static void print_record(const TraceRecord* record, int csv) {
+    if (csv) {
+        printf("%u,%u,%d,%s,%u,%u,%u\n", record->step, record->colony_id, record->ant_id,
+               event_name(record->type), record->x, record->y, record->detail);
+        return;
+    }
+
+    printf("step %u colony %u ant %d %s at (%u, %u)", record->step, record->colony_id,
+           record->ant_id, event_name(record->type), record->x, record->y);
+    switch (record->type) {
+        case TRACE_EVENT_MOVE: printf(" direction %u", record->detail); break;
+        case TRACE_EVENT_PICKUP: printf(" food left %u", record->detail); break;
+        case TRACE_EVENT_DELIVERY: printf(" delivered %u", record->detail); break;
+        default: break;
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* filename = NULL;
+    int csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (filename == NULL) {
+            filename = argv[i];
+        }
+    }
+    if (filename == NULL) {
+        fprintf(stderr, "Usage: %s <trace file> [--csv]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", filename);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        fprintf(stderr, "%s is not an ant trace\n", filename);
+        fclose(file);
+        return 1;
+    }
+    if (header.version != TRACE_FILE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s: unsupported trace version %u (record size %u)\n", filename,
+                header.version, header.record_size);
+        fclose(file);
+        return 1;
+    }
+
+    if (csv) {
+        printf("step,colony,ant,event,x,y,detail\n");
+    }
+
+    static TraceRecord records[DECODE_BATCH];
+    unsigned long long total = 0;
+    size_t count;
+    while ((count = fread(records, sizeof(TraceRecord), DECODE_BATCH, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            print_record(&records[i], csv);
+        }
+        total += count;
+    }
+
+    int truncated = !feof(file) || ferror(file);
+    fclose(file);
+    fprintf(stderr, "%llu events%s\n", total, truncated ? " (read error)" : "");
+    return truncated ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+#include "trace_log.h"
+#include "config.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+#include <windows.h>
+
+#define TRACE_RING_MASK (TRACE_RING_RECORDS - 1)
+#define TRACE_MAX_RINGS MAX_THREAD_COUNT
+#define TRACE_FILE_BUFFER_BYTES (1 << 20)
+
+// Single-producer, single-consumer ring. Indices run freely and wrap;
+// head is only written by the recording thread and tail by the writer
+// thread, each on its own cache line.
+typedef struct {
+    volatile LONG head;       // Next record to write
+    uint32_t cached_tail;     // Producer's last look at tail
+    uint32_t dropped;         // Records lost to a full ring
+    char producer_pad[GRID_ALIGNMENT - sizeof(LONG) - 2 * sizeof(uint32_t)];
+    volatile LONG tail;       // Next record to drain
+    char consumer_pad[GRID_ALIGNMENT - sizeof(LONG)];
+    TraceRecord records[TRACE_RING_RECORDS];
+} TraceRing;
+
+int trace_enabled = 0;
+
+// Trace state. Rings belong to one trace; a thread's cached ring is only
+// used while its session matches.
+static FILE* trace_file = NULL;
+static char* trace_file_buffer = NULL;
+static HANDLE writer_thread = NULL;
+static volatile LONG writer_stop = 0;
+static CRITICAL_SECTION ring_lock;
+static TraceRing* rings[TRACE_MAX_RINGS];
+static int ring_count = 0;
+static volatile LONG unregistered_drops = 0;
+static uint64_t records_written = 0;
+static int write_failed = 0;
+static unsigned int trace_session = 0;
+
+static THREAD_LOCAL TraceRing* thread_ring = NULL;
+static THREAD_LOCAL unsigned int thread_session = 0;
+
+// Give the calling thread a ring for the current trace; NULL when out of
+// rings or memory
+static TraceRing* register_ring(void) {
+    TraceRing* ring = NULL;
+
+    EnterCriticalSection(&ring_lock);
+    if (ring_count < TRACE_MAX_RINGS) {
+        ring = (TraceRing*)safe_aligned_calloc(1, sizeof(TraceRing), GRID_ALIGNMENT);
+        if (ring != NULL) {
+            rings[ring_count++] = ring;
+        }
+    }
+    LeaveCriticalSection(&ring_lock);
+
+    thread_ring = ring;
+    thread_session = trace_session;
+    return ring;
+}
+
+// The calling thread's ring for the current trace, NULL when it has none
+static TraceRing* get_thread_ring(void) {
+    if (thread_session != trace_session) {
+        return register_ring();
+    }
+    return thread_ring;
+}
+
+// Whether ring has room for another record. Only re-reads the writer's
+// tail when the ring looks full.
+static int ring_has_room(TraceRing* ring) {
+    uint32_t head = (uint32_t)ring->head;
+    if (head - ring->cached_tail < TRACE_RING_RECORDS) return 1;
+    ring->cached_tail = (uint32_t)ReadAcquire(&ring->tail);
+    return head - ring->cached_tail < TRACE_RING_RECORDS;
+}
+
+static void push_record(TraceRing* ring, int type, int colony_id, int ant_id, int x, int y, int step,
+                        int detail) {
+    uint32_t head = (uint32_t)ring->head;
+    TraceRecord* record = &ring->records[head & TRACE_RING_MASK];
+    record->step = (uint32_t)step;
+    record->ant_id = ant_id;
+    record->x = (uint16_t)x;
+    record->y = (uint16_t)y;
+    record->detail = (uint16_t)detail;
+    record->type = (uint8_t)type;
+    record->colony_id = (uint8_t)colony_id;
+    WriteRelease(&ring->head, (LONG)(head + 1));
+}
+
+void trace_ant_event(int type, int colony_id, int ant_id, int x, int y, int step, int detail) {
+    TraceRing* ring = get_thread_ring();
+    if (ring == NULL) {
+        InterlockedIncrement(&unregistered_drops);
+        return;
+    }
+    if (!ring_has_room(ring)) {
+        ring->dropped++;
+        return;
+    }
+    push_record(ring, type, colony_id, ant_id, x, y, step, detail);
+}
+
+void trace_ant_event_waiting(int type, int colony_id, int ant_id, int x, int y, int step, int detail) {
+    TraceRing* ring = get_thread_ring();
+    if (ring == NULL) {
+        InterlockedIncrement(&unregistered_drops);
+        return;
+    }
+    // The writer keeps draining until stop_trace_log, which can't run
+    // while this thread is recording
+    while (!ring_has_room(ring)) {
+        Sleep(TRACE_DRAIN_INTERVAL_MS);
+    }
+    push_record(ring, type, colony_id, ant_id, x, y, step, detail);
+}
+
+// Writer thread
+static int write_records(const TraceRecord* records, uint32_t count) {
+    if (count == 0 || write_failed) return 1;
+    if (fwrite(records, sizeof(TraceRecord), count, trace_file) != count) {
+        write_failed = 1;
+        return 0;
+    }
+    return 1;
+}
+
+// Append everything published so far; returns the number of records taken
+static uint32_t drain_rings(void) {
+    uint32_t drained = 0;
+
+    EnterCriticalSection(&ring_lock);
+    for (int i = 0; i < ring_count; i++) {
+        TraceRing* ring = rings[i];
+        uint32_t tail = (uint32_t)ring->tail;
+        uint32_t head = (uint32_t)ReadAcquire(&ring->head);
+        uint32_t count = head - tail;
+        if (count == 0) continue;
+
+        // At most two runs: up to the end of the buffer, then from its start
+        uint32_t start = tail & TRACE_RING_MASK;
+        uint32_t first_run = (count < TRACE_RING_RECORDS - start) ? count : TRACE_RING_RECORDS - start;
+        write_records(ring->records + start, first_run);
+        write_records(ring->records, count - first_run);
+
+        WriteRelease(&ring->tail, (LONG)head);
+        drained += count;
+    }
+    LeaveCriticalSection(&ring_lock);
+
+    records_written += drained;
+    return drained;
+}
+
+static DWORD WINAPI writer_main(LPVOID parameter) {
+    (void)parameter;
+
+    for (;;) {
+        // Producers are quiet once stop is requested, so one more sweep
+        // after seeing it empties every ring
+        int stopping = ReadAcquire(&writer_stop) != 0;
+        uint32_t drained = drain_rings();
+        if (stopping) break;
+        if (drained == 0) {
+            Sleep(TRACE_DRAIN_INTERVAL_MS);
+        }
+    }
+    return 0;
+}
+
+// Trace lifecycle
+int start_trace_log(const char* filename) {
+    if (filename == NULL) return 0;
+    stop_trace_log();
+
+    trace_file = fopen(filename, "wb");
+    if (trace_file == NULL) {
+        print_error("Cannot open trace file %s", filename);
+        return 0;
+    }
+    trace_file_buffer = (char*)safe_malloc(TRACE_FILE_BUFFER_BYTES);
+    if (trace_file_buffer != NULL) {
+        setvbuf(trace_file, trace_file_buffer, _IOFBF, TRACE_FILE_BUFFER_BYTES);
+    }
+
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FILE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    if (fwrite(&header, sizeof(header), 1, trace_file) != 1) {
+        print_error("Cannot write trace file %s", filename);
+        fclose(trace_file);
+        trace_file = NULL;
+        safe_free(trace_file_buffer);
+        trace_file_buffer = NULL;
+        return 0;
+    }
+
+    InitializeCriticalSection(&ring_lock);
+    ring_count = 0;
+    unregistered_drops = 0;
+    records_written = 0;
+    write_failed = 0;
+    writer_stop = 0;
+    trace_session++;
+
+    writer_thread = CreateThread(NULL, 0, writer_main, NULL, 0, NULL);
+    if (writer_thread == NULL) {
+        print_error("Failed to start trace writer thread");
+        DeleteCriticalSection(&ring_lock);
+        fclose(trace_file);
+        trace_file = NULL;
+        safe_free(trace_file_buffer);
+        trace_file_buffer = NULL;
+        return 0;
+    }
+
+    trace_enabled = 1;
+    print_info("Tracing ant events to %s", filename);
+    return 1;
+}
+
+void stop_trace_log(void) {
+    if (writer_thread == NULL) return;
+
+    trace_enabled = 0;
+    WriteRelease(&writer_stop, 1);
+    WaitForSingleObject(writer_thread, INFINITE);
+    CloseHandle(writer_thread);
+    writer_thread = NULL;
+
+    uint64_t dropped = (uint64_t)unregistered_drops;
+    for (int i = 0; i < ring_count; i++) {
+        dropped += rings[i]->dropped;
+        safe_aligned_free(rings[i]);
+        rings[i] = NULL;
+    }
+    ring_count = 0;
+    DeleteCriticalSection(&ring_lock);
+
+    if (fclose(trace_file) != 0) {
+        write_failed = 1;
+    }
+    trace_file = NULL;
+    safe_free(trace_file_buffer);
+    trace_file_buffer = NULL;
+
+    if (write_failed) {
+        print_error("Trace file is incomplete: write failed");
+    }
+    print_info("Trace closed: %llu events written, %llu dropped",
+               (unsigned long long)records_written, (unsigned long long)dropped);
+}
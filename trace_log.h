@@ -0,0 +1,62 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <stdint.h>
+
+// Binary ant event trace. Threads write fixed-size records into their own
+// ring buffer without locking or formatting, and a background thread
+// appends the rings to the trace file. When a ring is full its records
+// are dropped and counted rather than stalling the simulation. The file
+// keeps each thread's records in order, but the writer drains the rings
+// one after another, so records of different threads interleave in
+// chunks and a later step's records can come before an earlier one's;
+// sort by step when step order matters. The trace_decode tool turns a
+// file back into text or CSV.
+
+// Event types
+#define TRACE_EVENT_SPAWN     1
+#define TRACE_EVENT_MOVE      2  // detail: direction (0-7)
+#define TRACE_EVENT_PICKUP    3  // detail: food left in the cell
+#define TRACE_EVENT_DELIVERY  4  // detail: food delivered
+#define TRACE_EVENT_DEATH     5
+
+typedef struct {
+    uint32_t step;
+    int32_t ant_id;
+    uint16_t x;
+    uint16_t y;
+    uint16_t detail;
+    uint8_t type;       // TRACE_EVENT_*
+    uint8_t colony_id;
+} TraceRecord;
+
+// File layout: one header, then records to the end of the file
+#define TRACE_FILE_MAGIC "ANTTRACE"
+#define TRACE_FILE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;  // sizeof(TraceRecord)
+} TraceFileHeader;
+
+// Recording costs one branch while no trace is open
+extern int trace_enabled;
+
+#define TRACE_ANT_EVENT(type, colony_id, ant_id, x, y, step, detail) \
+    do { \
+        if (trace_enabled) trace_ant_event((type), (colony_id), (ant_id), (x), (y), (step), (detail)); \
+    } while (0)
+
+void trace_ant_event(int type, int colony_id, int ant_id, int x, int y, int step, int detail);
+
+// Waits for the writer instead of dropping when the ring is full, for
+// bursts outside the ant step such as bulk spawns
+void trace_ant_event_waiting(int type, int colony_id, int ant_id, int x, int y, int step, int detail);
+
+// Trace lifecycle. Start and stop between steps, while no other thread
+// records events.
+int start_trace_log(const char* filename);
+void stop_trace_log(void);
+
+#endif // TRACE_LOG_H
@@ -5,48 +5,153 @@
 #include <string.h>
 #include <time.h>
 #include <stdarg.h>
+#include <malloc.h>
 #include <windows.h>
 
-// Random number generation
-static int random_initialized = 0;
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define CPU_FEATURES_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define CPU_FEATURES_X86 0
+#endif
+
+// Random number generation. Every draw is Philox4x32-10 applied to the
+// seed and a 128-bit counter, so a draw depends only on where it sits in
+// its sequence and any thread can produce any part of any sequence.
+// Counters are { position, stream, domain }: each thread reads its own
+// stream in the thread domain, and keyed draws (one block per key and
+// step, see fill_keyed_random_draws) use the keyed domain.
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define RANDOM_DOMAIN_THREAD 0
+#define RANDOM_DOMAIN_KEYED 1
+
+static uint64_t random_seed = 0x853C49E6748FEA9BULL;  // Until init_random or set_random_seed
+static int random_seeded = 0;
+static volatile LONG random_thread_streams = 0;
+static volatile LONG random_seed_epoch = 0;  // Bumped by every set_random_seed
+
+// Per-thread sequence position and the unread part of the last block
+typedef struct {
+    uint32_t epoch;   // Seed the state belongs to; a stale thread restarts
+    uint32_t stream;  // 0 until the thread's first draw under the seed
+    uint64_t position;
+    uint32_t block[4];
+    int left;
+} ThreadRandom;
+
+static THREAD_LOCAL ThreadRandom thread_random;
+
+static void philox4x32(const uint32_t counter[4], uint64_t seed, uint32_t out[4]) {
+    uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+    uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+    
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * x0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * x2;
+        x0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+        x1 = (uint32_t)p1;
+        x2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+        x3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+}
 
 void init_random(void) {
-    if (!random_initialized) {
-        srand((unsigned int)time(NULL));
-        random_initialized = 1;
+    if (!random_seeded) {
+        set_random_seed((uint64_t)time(NULL));
     }
 }
 
-int random_int(int min, int max) {
-    if (!random_initialized) {
-        init_random();
+// Every thread restarts on its next draw and takes a new stream number,
+// so stream numbers are handed out afresh without two threads sharing one
+void set_random_seed(uint64_t seed) {
+    random_seed = seed;
+    random_seeded = 1;
+    random_thread_streams = 0;
+    InterlockedIncrement(&random_seed_epoch);
+}
+
+uint64_t get_random_seed(void) {
+    return random_seed;
+}
+
+uint32_t random_uint32(void) {
+    ThreadRandom* state = &thread_random;
+    uint32_t epoch = (uint32_t)random_seed_epoch;
+    if (state->epoch != epoch) {
+        memset(state, 0, sizeof(ThreadRandom));
+        state->epoch = epoch;
+    }
+    if (state->left == 0) {
+        if (state->stream == 0) {
+            state->stream = (uint32_t)InterlockedIncrement(&random_thread_streams);
+        }
+        uint32_t counter[4] = { (uint32_t)state->position, (uint32_t)(state->position >> 32),
+                                state->stream, RANDOM_DOMAIN_THREAD };
+        philox4x32(counter, random_seed, state->block);
+        state->position++;
+        state->left = 4;
     }
+    return state->block[4 - state->left--];
+}
+
+int random_int(int min, int max) {
     if (min > max) {
         int temp = min;
         min = max;
         max = temp;
     }
-    return min + (rand() % (max - min + 1));
+    // Multiply-shift instead of modulo: no bias worth measuring
+    uint64_t range = (uint64_t)((int64_t)max - min + 1);
+    return (int)(min + (int64_t)(((uint64_t)random_uint32() * range) >> 32));
 }
 
 float random_float(float min, float max) {
-    if (!random_initialized) {
-        init_random();
-    }
     if (min > max) {
         float temp = min;
         min = max;
         max = temp;
     }
-    float scale = (float)rand() / (float)RAND_MAX;
-    return min + scale * (max - min);
+    return min + RANDOM_DRAW_UNIT(random_uint32()) * (max - min);
 }
 
 float random_probability(void) {
-    if (!random_initialized) {
-        init_random();
+    return RANDOM_DRAW_UNIT(random_uint32());
+}
+
+// Batched fills
+void fill_random_uint32(uint32_t* values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = random_uint32();
+    }
+}
+
+void fill_keyed_random_draws(uint32_t* draws, int draws_per_key, const int32_t* keys, int count,
+                             uint32_t stream, uint32_t step) {
+    uint32_t counter[4] = { 0, step, stream, RANDOM_DOMAIN_KEYED };
+    uint32_t block[4];
+    
+    for (int i = 0; i < count; i++) {
+        counter[0] = (uint32_t)keys[i];
+        philox4x32(counter, random_seed, block);
+        for (int j = 0; j < draws_per_key; j++) {
+            draws[j] = block[j];
+        }
+        draws += draws_per_key;
     }
-    return (float)rand() / (float)RAND_MAX;
 }
 
 // Memory utilities
@@ -82,6 +187,33 @@ void safe_free(void* ptr) {
     }
 }
 
+void* safe_aligned_calloc(size_t count, size_t size, size_t alignment) {
+    if (count == 0 || size == 0) {
+        print_error("Attempted to allocate 0 bytes");
+        return NULL;
+    }
+    
+    if (count > ((size_t)-1) / size) {
+        print_error("Memory allocation size overflow");
+        return NULL;
+    }
+    
+    void* ptr = _aligned_malloc(count * size, alignment);
+    if (ptr == NULL) {
+        print_error("Memory allocation failed");
+        return NULL;
+    }
+    
+    memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void safe_aligned_free(void* ptr) {
+    if (ptr != NULL) {
+        _aligned_free(ptr);
+    }
+}
+
 // String utilities
 int safe_strcpy(char* dest, const char* src, size_t dest_size) {
     if (dest == NULL || src == NULL || dest_size == 0) {
@@ -178,6 +310,89 @@ float lerp(float a, float b, float t) {
     return a + t * (b - a);
 }
 
+int lowest_set_bit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+int count_set_bits(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#else
+    // MSVC's __popcnt64 needs a CPU with POPCNT
+    int count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+// CPU feature detection. Both report 0 on targets without x86 SIMD.
+#if CPU_FEATURES_X86
+static void read_cpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; i++) {
+        regs[i] = (unsigned int)info[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+int cpu_has_sse2(void) {
+    unsigned int regs[4];
+    read_cpuid(1, 0, regs);
+    return (regs[3] & (1u << 26)) != 0;
+}
+
+int cpu_has_avx2(void) {
+    unsigned int regs[4];
+    read_cpuid(0, 0, regs);
+    if (regs[0] < 7) return 0;
+
+    // The OS must save the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+    read_cpuid(1, 0, regs);
+    int has_avx = (regs[2] & (1u << 28)) != 0;
+    int has_osxsave = (regs[2] & (1u << 27)) != 0;
+    if (!has_avx || !has_osxsave) return 0;
+
+#if defined(_MSC_VER)
+    unsigned long long xcr0 = _xgetbv(0);
+#else
+    unsigned int xcr0_low, xcr0_high;
+    __asm__ volatile ("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    unsigned long long xcr0 = ((unsigned long long)xcr0_high << 32) | xcr0_low;
+#endif
+    if ((xcr0 & 0x6) != 0x6) return 0;
+
+    read_cpuid(7, 0, regs);
+    return (regs[1] & (1u << 5)) != 0;
+}
+#else
+int cpu_has_sse2(void) {
+    return 0;
+}
+
+int cpu_has_avx2(void) {
+    return 0;
+}
+#endif
+
 // Debug utilities - disabled to avoid compilation issues
 // Can be enabled later if needed for debugging
 /*
@@ -222,36 +437,80 @@ void debug_print_ant_state(const Ant* ant) {
 #endif
 */
 
-// Error handling
+// Logging
+int log_level = DEFAULT_LOG_LEVEL;
+
+static const char* const log_level_names[] = { "error", "warning", "info", "debug", "trace" };
+static const char* const log_level_prefixes[] = { "[ERROR] ", "[WARNING] ", "[INFO] ", "[DEBUG] ", "[TRACE] " };
+static const int log_level_colors[] = {
+    COLOR_BRIGHT_RED, COLOR_BRIGHT_YELLOW, COLOR_BRIGHT_CYAN, COLOR_WHITE, COLOR_WHITE
+};
+
+void set_log_level(int level) {
+    log_level = clamp_int(level, LOG_LEVEL_ERROR, LOG_LEVEL_TRACE);
+    if (log_level > LOG_COMPILE_LEVEL) {
+        print_warning("Log level %s is not built in; messages stop at %s",
+                      get_log_level_name(log_level), get_log_level_name(LOG_COMPILE_LEVEL));
+    }
+}
+
+int parse_log_level(const char* text) {
+    if (text == NULL) return -1;
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_TRACE; level++) {
+        if (strcmp(text, log_level_names[level]) == 0) return level;
+    }
+    
+    char* end;
+    long level = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || level < LOG_LEVEL_ERROR || level > LOG_LEVEL_TRACE) return -1;
+    return (int)level;
+}
+
+const char* get_log_level_name(int level) {
+    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_TRACE) return "unknown";
+    return log_level_names[level];
+}
+
+// Callers have already checked the level
+static void log_vmessage(int level, const char* format, va_list args) {
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    SetConsoleTextAttribute(console, (WORD)log_level_colors[level]);
+    printf("%s", log_level_prefixes[level]);
+    vprintf(format, args);
+    printf("\n");
+    SetConsoleTextAttribute(console, COLOR_WHITE);
+}
+
+void log_message(int level, const char* format, ...) {
+    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_TRACE || level > log_level) return;
+    
+    va_list args;
+    va_start(args, format);
+    log_vmessage(level, format, args);
+    va_end(args);
+}
+
 void print_error(const char* format, ...) {
     va_list args;
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_BRIGHT_RED);
-    printf("[ERROR] ");
     va_start(args, format);
-    vprintf(format, args);
+    log_vmessage(LOG_LEVEL_ERROR, format, args);
     va_end(args);
-    printf("\n");
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_WHITE);
 }
 
 void print_warning(const char* format, ...) {
+    if (!LOG_ENABLED(LOG_LEVEL_WARNING)) return;
+    
     va_list args;
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_BRIGHT_YELLOW);
-    printf("[WARNING] ");
     va_start(args, format);
-    vprintf(format, args);
+    log_vmessage(LOG_LEVEL_WARNING, format, args);
     va_end(args);
-    printf("\n");
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_WHITE);
 }
 
 void print_info(const char* format, ...) {
+    if (!LOG_ENABLED(LOG_LEVEL_INFO)) return;
+    
     va_list args;
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_BRIGHT_CYAN);
-    printf("[INFO] ");
     va_start(args, format);
-    vprintf(format, args);
+    log_vmessage(LOG_LEVEL_INFO, format, args);
     va_end(args);
-    printf("\n");
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), COLOR_WHITE);
 }
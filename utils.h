@@ -4,16 +4,41 @@
 #include <stdint.h>
 #include "data_structures.h"
 
-// Random number generation
+// Thread-local storage class
+#ifdef _MSC_VER
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL _Thread_local
+#endif
+
+// Random number generation (counter-based, see utils.c). Each thread draws
+// from its own stream; init_random seeds from the clock unless
+// set_random_seed came first. Reseed while no other thread is drawing.
 void init_random(void);
+void set_random_seed(uint64_t seed);
+uint64_t get_random_seed(void);
+uint32_t random_uint32(void);
 int random_int(int min, int max);
 float random_float(float min, float max);
-float random_probability(void);
+float random_probability(void);  // [0, 1)
+
+// Batched fills. fill_keyed_random_draws writes draws_per_key (at most 4)
+// draws for each key that depend only on the seed, key, stream and step,
+// so they come out the same whichever thread makes them and in any order.
+void fill_random_uint32(uint32_t* values, size_t count);
+void fill_keyed_random_draws(uint32_t* draws, int draws_per_key, const int32_t* keys, int count,
+                             uint32_t stream, uint32_t step);
+
+// Turning a 32-bit draw into a choice among n or a float in [0, 1)
+#define RANDOM_DRAW_BELOW(draw, n) ((int)(((uint64_t)(draw) * (uint32_t)(n)) >> 32))
+#define RANDOM_DRAW_UNIT(draw) ((float)((draw) >> 8) * (1.0f / 16777216.0f))
 
 // Memory utilities
 void* safe_malloc(size_t size);
 void* safe_calloc(size_t count, size_t size);
 void safe_free(void* ptr);
+void* safe_aligned_calloc(size_t count, size_t size, size_t alignment);
+void safe_aligned_free(void* ptr);
 
 // String utilities
 int safe_strcpy(char* dest, const char* src, size_t dest_size);
@@ -28,6 +53,12 @@ uint64_t get_time_ms(void);
 float clamp_float(float value, float min, float max);
 int clamp_int(int value, int min, int max);
 float lerp(float a, float b, float t);
+int lowest_set_bit(uint64_t bits);  // bits must be non-zero
+int count_set_bits(uint64_t bits);
+
+// CPU feature detection
+int cpu_has_sse2(void);
+int cpu_has_avx2(void);
 
 // Debug utilities
 #ifdef _DEBUG
@@ -40,7 +71,25 @@ void debug_print_ant_state(const Ant* ant);
 #define debug_print_ant_state(ant)
 #endif
 
-// Error handling
+// Logging. print_error, print_warning and print_info log at their level.
+// The LOG_* macros are for hot paths: levels above LOG_COMPILE_LEVEL
+// compile to nothing, arguments included, and the rest cost one branch
+// on log_level while filtered out at runtime.
+extern int log_level;  // Most verbose level printed; change with set_log_level
+
+#define LOG_ENABLED(level) ((level) <= LOG_COMPILE_LEVEL && (level) <= log_level)
+#define LOG_AT(level, ...) \
+    do { if (LOG_ENABLED(level)) log_message((level), __VA_ARGS__); } while (0)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LOG_LEVEL_WARNING, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, __VA_ARGS__)
+
+void set_log_level(int level);
+int parse_log_level(const char* text);  // Name or number; -1 if neither
+const char* get_log_level_name(int level);
+void log_message(int level, const char* format, ...);
 void print_error(const char* format, ...);
 void print_warning(const char* format, ...);
 void print_info(const char* format, ...);
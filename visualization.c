@@ -2,6 +2,8 @@
 #include "config.h"
 #include "utils.h"
 #include "pheromones.h"
+#include "world.h"
+#include "ant_logic.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -75,6 +77,12 @@ void show_cursor(void) {
     }
 }
 
+// Empty terrain without pheromone renders as the border's blank fill
+static int is_blank_cell(const Cell* cell) {
+    return cell->terrain == TERRAIN_EMPTY &&
+           cell->pheromone_food <= 0.0f && cell->pheromone_home <= 0.0f;
+}
+
 // World rendering
 void render_world(const World* world) {
     if (world == NULL) return;
@@ -82,10 +90,40 @@ void render_world(const World* world) {
     clear_screen();
     render_border(world);
     
-    // Render each cell
-    for (int y = 0; y < world->height; y++) {
-        for (int x = 0; x < world->width; x++) {
-            render_cell(&world->grid[y][x], x, y, world);
+    // Render each cell that differs from the blank interior render_border
+    // drew. Unallocated tiles are entirely blank, and tiles without active
+    // pheromone only need their terrain.
+    Cell cell;
+    for (int tile_y = 0; tile_y < world->tiles_y; tile_y++) {
+        for (int tile_x = 0; tile_x < world->tiles_x; tile_x++) {
+            if (world->tiles[(size_t)tile_y * world->tiles_x + tile_x] == NULL) continue;
+            int active = is_tile_active(world, tile_x, tile_y);
+            
+            int x0 = tile_x << WORLD_TILE_SHIFT;
+            int y0 = tile_y << WORLD_TILE_SHIFT;
+            int x1 = (x0 + WORLD_TILE_SIZE < world->width) ? x0 + WORLD_TILE_SIZE : world->width;
+            int y1 = (y0 + WORLD_TILE_SIZE < world->height) ? y0 + WORLD_TILE_SIZE : world->height;
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    if (!active && get_terrain(world, x, y) == TERRAIN_EMPTY) continue;
+                    if (get_cell(world, x, y, &cell) && !is_blank_cell(&cell)) {
+                        render_cell(&cell, x, y, world);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Ants standing on skipped cells
+    for (int i = 0; i < world->colony_count; i++) {
+        const AntStore* ants = &world->colonies[i].ants;
+        for (int index = 0; index < ants->count; index++) {
+            if (ants->state[index] & ANT_STATE_DEAD) continue;
+            int x = ants->x[index];
+            int y = ants->y[index];
+            if (get_cell(world, x, y, &cell) && is_blank_cell(&cell)) {
+                render_cell(&cell, x, y, world);
+            }
         }
     }
     
@@ -99,25 +137,25 @@ void render_cell(const Cell* cell, int x, int y, const World* world) {
     if (cell == NULL || world == NULL) return;
     
     // Check if there's an ant at this position
-    Ant* ant_at_position = NULL;
-    for (int i = 0; i < world->colony_count; i++) {
-        Ant* current = world->colonies[i].ants_head;
-        while (current != NULL) {
-            if (current->pos.x == x && current->pos.y == y && !(current->state & ANT_STATE_DEAD)) {
-                ant_at_position = current;
+    Ant ant_at_position;
+    int found = 0;
+    for (int i = 0; i < world->colony_count && !found; i++) {
+        const AntStore* ants = &world->colonies[i].ants;
+        for (int index = 0; index < ants->count; index++) {
+            if (ants->x[index] == x && ants->y[index] == y && !(ants->state[index] & ANT_STATE_DEAD)) {
+                get_ant(&world->colonies[i], index, &ant_at_position);
+                found = 1;
                 break;
             }
-            current = current->next;
         }
-        if (ant_at_position) break;
     }
     
     // Position cursor for this cell
     gotoxy(x + 2, y + 2); // +2 for border offset
     
-    if (ant_at_position) {
+    if (found) {
         // Render ant
-        render_ant(ant_at_position, x, y);
+        render_ant(&ant_at_position, x, y);
     } else {
         // Render terrain and pheromones
         char symbol = get_terrain_symbol(cell->terrain);
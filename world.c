@@ -1,6 +1,9 @@
 #include "world.h"
 #include "config.h"
 #include "utils.h"
+#include "pheromones.h"
+#include "ant_logic.h"
+#include "slab_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,6 +31,15 @@ World* create_world(int width, int height, int colony_count) {
     world->height = height;
     world->colony_count = colony_count;
     world->current_step = 0;
+    world->lazy_evaporation = 0;
+    world->pheromone_clock = 0;
+    world->pheromone_block_steps = 1;
+    world->pheromone_pending_steps = 0;
+    world->pheromone_gradients = 0;
+    world->pheromone_version = 0;
+    world->initial_ants = INITIAL_ANTS_PER_COLONY;
+    world->ant_capacity = DEFAULT_ANTS_PER_COLONY;
+    world->ant_sort_interval = DEFAULT_ANT_SORT_INTERVAL;
     world->is_running = 0;
     world->paused = 0;
     world->render_delay_ms = RENDER_DELAY_MS;
@@ -45,41 +57,31 @@ World* create_world(int width, int height, int colony_count) {
         world->colonies[i].food_collected = 0;
         world->colonies[i].total_ants = 0;
         world->colonies[i].active_ants = 0;
-        world->colonies[i].ants_head = NULL;
         world->colonies[i].efficiency_score = 0.0f;
         world->colonies[i].color = i + 1; // Different color for each colony
+        set_path_history_length(&world->colonies[i], PATH_HISTORY_LENGTH);
     }
     
-    // Allocate 2D grid
-    world->grid = (Cell**)safe_malloc(height * sizeof(Cell*));
-    if (world->grid == NULL) {
+    // Allocate the tile directory; tiles themselves are created on demand
+    world->tiles_x = (width + WORLD_TILE_SIZE - 1) >> WORLD_TILE_SHIFT;
+    world->tiles_y = (height + WORLD_TILE_SIZE - 1) >> WORLD_TILE_SHIFT;
+    world->allocated_tiles = 0;
+    world->pheromone_channels = colony_count * PHEROMONE_TYPE_COUNT;
+    world->tiles = (WorldTile**)safe_calloc((size_t)world->tiles_x * (size_t)world->tiles_y, sizeof(WorldTile*));
+    if (world->tiles == NULL) {
         safe_free(world->colonies);
         safe_free(world);
         return NULL;
     }
     
-    // Allocate each row
-    for (int i = 0; i < height; i++) {
-        world->grid[i] = (Cell*)safe_calloc(width, sizeof(Cell));
-        if (world->grid[i] == NULL) {
-            // Clean up already allocated rows
-            for (int j = 0; j < i; j++) {
-                safe_free(world->grid[j]);
-            }
-            safe_free(world->grid);
-            safe_free(world->colonies);
-            safe_free(world);
-            return NULL;
-        }
-        
-        // Initialize all cells to empty
-        for (int j = 0; j < width; j++) {
-            world->grid[i][j].terrain = TERRAIN_EMPTY;
-            world->grid[i][j].pheromone_food = PHEROMONE_INITIAL;
-            world->grid[i][j].pheromone_home = PHEROMONE_INITIAL;
-            world->grid[i][j].food_amount = 0;
-            world->grid[i][j].colony_id = -1;
-        }
+    world->active_row_words = (world->tiles_x + 63) >> 6;
+    world->active_tiles = (uint64_t*)safe_calloc((size_t)world->active_row_words * (size_t)world->tiles_y,
+                                                 sizeof(uint64_t));
+    if (world->active_tiles == NULL) {
+        safe_free(world->tiles);
+        safe_free(world->colonies);
+        safe_free(world);
+        return NULL;
     }
     
     print_info("World created successfully");
@@ -91,22 +93,18 @@ void destroy_world(World* world) {
     
     // Free all ants in all colonies
     for (int i = 0; i < world->colony_count; i++) {
-        Colony* colony = &world->colonies[i];
-        Ant* current = colony->ants_head;
-        while (current != NULL) {
-            Ant* next = current->next;
-            safe_free(current);
-            current = next;
-        }
+        release_colony_ants(&world->colonies[i]);
     }
     
-    // Free grid rows
-    if (world->grid != NULL) {
-        for (int i = 0; i < world->height; i++) {
-            safe_free(world->grid[i]);
+    // Free allocated tiles
+    if (world->tiles != NULL) {
+        size_t tile_count = (size_t)world->tiles_x * (size_t)world->tiles_y;
+        for (size_t i = 0; i < tile_count; i++) {
+            safe_aligned_free(world->tiles[i]);
         }
-        safe_free(world->grid);
+        safe_free(world->tiles);
     }
+    safe_free(world->active_tiles);
     
     // Free colonies array
     safe_free(world->colonies);
@@ -117,6 +115,44 @@ void destroy_world(World* world) {
     print_info("World destroyed successfully");
 }
 
+// Walkable-neighbour masks
+static uint8_t compute_walk_mask(const World* world, int x, int y) {
+    uint8_t mask = 0;
+    for (int dir = 0; dir < 8; dir++) {
+        if (is_walkable(world, x + dx[dir], y + dy[dir])) {
+            mask |= (uint8_t)(1 << dir);
+        }
+    }
+    return mask;
+}
+
+// Update the masks of the cells around (x, y) after its terrain changed.
+// Cells in unallocated tiles get theirs when the tile is created.
+static void update_walk_masks(World* world, int x, int y) {
+    int walkable = is_walkable(world, x, y);
+    for (int dir = 0; dir < 8; dir++) {
+        int nx = x + dx[dir];
+        int ny = y + dy[dir];
+        WorldTile* tile = get_tile(world, nx, ny);
+        if (tile == NULL) continue;
+        
+        // The neighbour sees (x, y) in the opposite direction
+        uint8_t bit = (uint8_t)(1 << ((dir + 4) & 7));
+        int index = TILE_CELL_INDEX(nx, ny);
+        if (walkable) {
+            tile->walk_mask[index] |= bit;
+        } else {
+            tile->walk_mask[index] &= (uint8_t)~bit;
+        }
+    }
+}
+
+uint8_t get_walk_mask(const World* world, int x, int y) {
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return compute_walk_mask(world, x, y);
+    return tile->walk_mask[TILE_CELL_INDEX(x, y)];
+}
+
 // World manipulation
 void place_colony(World* world, int colony_id, int x, int y) {
     if (world == NULL || colony_id < 0 || colony_id >= world->colony_count) {
@@ -130,14 +166,14 @@ void place_colony(World* world, int colony_id, int x, int y) {
     }
     
     // Check if position is already occupied
-    if (world->grid[y][x].terrain != TERRAIN_EMPTY) {
+    if (get_terrain(world, x, y) != TERRAIN_EMPTY) {
         print_warning("Position already occupied, clearing first");
         clear_cell(world, x, y);
     }
     
     // Place colony
-    world->grid[y][x].terrain = TERRAIN_NEST;
-    world->grid[y][x].colony_id = colony_id;
+    set_terrain(world, x, y, TERRAIN_NEST);
+    set_nest_colony(world, x, y, colony_id);
     
     // Update colony position
     world->colonies[colony_id].nest_pos.x = x;
@@ -158,14 +194,14 @@ void place_food(World* world, int x, int y, int amount) {
     }
     
     // Check if position is already occupied
-    if (world->grid[y][x].terrain != TERRAIN_EMPTY) {
+    if (get_terrain(world, x, y) != TERRAIN_EMPTY) {
         print_warning("Position already occupied, clearing first");
         clear_cell(world, x, y);
     }
     
     // Place food
-    world->grid[y][x].terrain = TERRAIN_FOOD;
-    world->grid[y][x].food_amount = amount;
+    set_terrain(world, x, y, TERRAIN_FOOD);
+    set_food_amount(world, x, y, amount);
     
     print_info("Food placed at (%d, %d) with amount %d", x, y, amount);
 }
@@ -182,13 +218,13 @@ void place_obstacle(World* world, int x, int y) {
     }
     
     // Check if position is already occupied
-    if (world->grid[y][x].terrain != TERRAIN_EMPTY) {
+    if (get_terrain(world, x, y) != TERRAIN_EMPTY) {
         print_warning("Position already occupied, clearing first");
         clear_cell(world, x, y);
     }
     
     // Place obstacle
-    world->grid[y][x].terrain = TERRAIN_WALL;
+    set_terrain(world, x, y, TERRAIN_WALL);
     
     print_info("Obstacle placed at (%d, %d)", x, y);
 }
@@ -198,11 +234,19 @@ void clear_cell(World* world, int x, int y) {
         return;
     }
     
-    world->grid[y][x].terrain = TERRAIN_EMPTY;
-    world->grid[y][x].pheromone_food = PHEROMONE_INITIAL;
-    world->grid[y][x].pheromone_home = PHEROMONE_INITIAL;
-    world->grid[y][x].food_amount = 0;
-    world->grid[y][x].colony_id = -1;
+    // Untouched tiles already hold empty cells
+    WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return;
+    
+    int index = TILE_CELL_INDEX(x, y);
+    tile->terrain[index] = TERRAIN_EMPTY;
+    for (int channel = 0; channel < world->pheromone_channels; channel++) {
+        TILE_PHEROMONE(tile, channel)[index] = PHEROMONE_LEVEL_FROM_FLOAT(PHEROMONE_INITIAL);
+    }
+    tile->food_amount[index] = 0;
+    tile->colony_id[index] = -1;
+    update_walk_masks(world, x, y);
+    invalidate_gradient_cells(world, x, y, -1);
 }
 
 // World queries
@@ -214,13 +258,202 @@ int is_valid_position(const World* world, int x, int y) {
 int is_walkable(const World* world, int x, int y) {
     if (!is_valid_position(world, x, y)) return 0;
     
-    TerrainType terrain = world->grid[y][x].terrain;
-    return (terrain == TERRAIN_EMPTY || terrain == TERRAIN_FOOD || terrain == TERRAIN_NEST);
+    TerrainType terrain = get_terrain(world, x, y);
+    return TERRAIN_WALKABLE(terrain);
 }
 
-Cell* get_cell(const World* world, int x, int y) {
+int get_cell(const World* world, int x, int y, Cell* cell) {
+    if (!is_valid_position(world, x, y) || cell == NULL) return 0;
+    
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) {
+        cell->terrain = TERRAIN_EMPTY;
+        cell->pheromone_food = PHEROMONE_INITIAL;
+        cell->pheromone_home = PHEROMONE_INITIAL;
+        cell->food_amount = 0;
+        cell->colony_id = -1;
+        return 1;
+    }
+    
+    int index = TILE_CELL_INDEX(x, y);
+    cell->terrain = (TerrainType)tile->terrain[index];
+    cell->pheromone_food = PHEROMONE_INITIAL;
+    cell->pheromone_home = PHEROMONE_INITIAL;
+    for (int i = 0; i < world->colony_count; i++) {
+        float food = get_tile_pheromone(world, tile, PHEROMONE_CHANNEL(i, PHEROMONE_FOOD), index);
+        float home = get_tile_pheromone(world, tile, PHEROMONE_CHANNEL(i, PHEROMONE_HOME), index);
+        if (food > cell->pheromone_food) cell->pheromone_food = food;
+        if (home > cell->pheromone_home) cell->pheromone_home = home;
+    }
+    cell->food_amount = tile->food_amount[index];
+    cell->colony_id = tile->colony_id[index];
+    return 1;
+}
+
+// Tile access
+WorldTile* get_tile(const World* world, int x, int y) {
     if (!is_valid_position(world, x, y)) return NULL;
-    return &world->grid[y][x];
+    return world->tiles[WORLD_TILE_INDEX(world, x, y)];
+}
+
+WorldTile* get_or_create_tile(World* world, int x, int y) {
+    if (!is_valid_position(world, x, y)) return NULL;
+    
+    WorldTile** slot = &world->tiles[WORLD_TILE_INDEX(world, x, y)];
+    if (*slot == NULL) {
+        // Both pheromone buffers and the direction planes follow the tile
+        // header in one block
+        size_t header_size = (sizeof(WorldTile) + GRID_ALIGNMENT - 1) & ~(size_t)(GRID_ALIGNMENT - 1);
+        size_t buffer_size = (size_t)world->pheromone_channels * WORLD_TILE_CELLS * sizeof(PheromoneLevel);
+        size_t gradient_size = (size_t)world->pheromone_channels * WORLD_TILE_CELLS;
+        WorldTile* tile = (WorldTile*)safe_aligned_calloc(1, header_size + 2 * buffer_size + gradient_size,
+                                                          GRID_ALIGNMENT);
+        if (tile == NULL) {
+            return NULL;
+        }
+        tile->pheromone[0] = (PheromoneLevel*)((char*)tile + header_size);
+        tile->pheromone[1] = (PheromoneLevel*)((char*)tile + header_size + buffer_size);
+        tile->gradient = (uint8_t*)tile + header_size + 2 * buffer_size;
+        
+        // Zeroed memory is already empty terrain without pheromone or food
+        for (int i = 0; i < WORLD_TILE_CELLS; i++) {
+            tile->colony_id[i] = -1;
+        }
+        
+        // Empty cells only see the world edge and walls in neighbouring tiles
+        int x0 = x & ~WORLD_TILE_MASK;
+        int y0 = y & ~WORLD_TILE_MASK;
+        for (int i = 0; i < WORLD_TILE_CELLS; i++) {
+            tile->walk_mask[i] = compute_walk_mask(world, x0 + (i & WORLD_TILE_MASK), y0 + (i >> WORLD_TILE_SHIFT));
+        }
+        tile->decay_stamp = world->pheromone_clock;
+        tile->gradient_stamp = world->pheromone_version - 1;
+        
+        *slot = tile;
+        world->allocated_tiles++;
+    }
+    return *slot;
+}
+
+// Active pheromone tiles
+int is_tile_active(const World* world, int tile_x, int tile_y) {
+    return (int)((TILE_ACTIVE_ROW(world, tile_y)[tile_x >> 6] >> (tile_x & 63)) & 1);
+}
+
+void set_tile_active(World* world, int tile_x, int tile_y, int active) {
+    uint64_t* word = &TILE_ACTIVE_ROW(world, tile_y)[tile_x >> 6];
+    uint64_t bit = (uint64_t)1 << (tile_x & 63);
+    if (active) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+}
+
+int next_active_tile(const World* world, int tile_y, int tile_x) {
+    const uint64_t* row = TILE_ACTIVE_ROW(world, tile_y);
+    for (int w = tile_x >> 6; w < world->active_row_words; w++) {
+        uint64_t bits = row[w];
+        if (w == tile_x >> 6) {
+            bits &= ~(uint64_t)0 << (tile_x & 63);
+        }
+        if (bits != 0) {
+            return (w << 6) + lowest_set_bit(bits);
+        }
+    }
+    return -1;
+}
+
+// Mark the direction-plane entries next to (x, y) for recomputation after
+// the cell's level in channel, or its terrain (channel -1), changed
+void invalidate_gradient_cells(World* world, int x, int y, int channel) {
+    if (!world->pheromone_gradients) return;
+    
+    for (int ny = y - 1; ny <= y + 1; ny++) {
+        for (int nx = x - 1; nx <= x + 1; nx++) {
+            WorldTile* tile = get_tile(world, nx, ny);
+            if (tile == NULL || tile->gradient_stamp != world->pheromone_version) continue;
+            if (nx == x && ny == y) continue;
+            
+            int index = TILE_CELL_INDEX(nx, ny);
+            if (channel >= 0) {
+                TILE_GRADIENT(tile, channel)[index] = GRADIENT_STALE;
+            } else {
+                for (int c = 0; c < world->pheromone_channels; c++) {
+                    TILE_GRADIENT(tile, c)[index] = GRADIENT_STALE;
+                }
+            }
+        }
+    }
+}
+
+int count_active_tiles(const World* world) {
+    int count = 0;
+    size_t word_count = (size_t)world->active_row_words * (size_t)world->tiles_y;
+    for (size_t i = 0; i < word_count; i++) {
+        count += count_set_bits(world->active_tiles[i]);
+    }
+    return count;
+}
+
+// Cell field accessors
+TerrainType get_terrain(const World* world, int x, int y) {
+    if (!is_valid_position(world, x, y)) return TERRAIN_WALL;
+    
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return TERRAIN_EMPTY;
+    return (TerrainType)tile->terrain[TILE_CELL_INDEX(x, y)];
+}
+
+void set_terrain(World* world, int x, int y, TerrainType terrain) {
+    WorldTile* tile = (terrain == TERRAIN_EMPTY) ? get_tile(world, x, y) : get_or_create_tile(world, x, y);
+    if (tile == NULL) return;
+    tile->terrain[TILE_CELL_INDEX(x, y)] = (uint8_t)terrain;
+    update_walk_masks(world, x, y);
+    invalidate_gradient_cells(world, x, y, -1);
+}
+
+int get_food_amount(const World* world, int x, int y) {
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return 0;
+    return tile->food_amount[TILE_CELL_INDEX(x, y)];
+}
+
+void set_food_amount(World* world, int x, int y, int amount) {
+    WorldTile* tile = (amount == 0) ? get_tile(world, x, y) : get_or_create_tile(world, x, y);
+    if (tile == NULL) return;
+    tile->food_amount[TILE_CELL_INDEX(x, y)] = amount;
+}
+
+int get_nest_colony(const World* world, int x, int y) {
+    const WorldTile* tile = get_tile(world, x, y);
+    if (tile == NULL) return -1;
+    return tile->colony_id[TILE_CELL_INDEX(x, y)];
+}
+
+void set_nest_colony(World* world, int x, int y, int colony_id) {
+    WorldTile* tile = (colony_id < 0) ? get_tile(world, x, y) : get_or_create_tile(world, x, y);
+    if (tile == NULL) return;
+    tile->colony_id[TILE_CELL_INDEX(x, y)] = (int16_t)colony_id;
+}
+
+int count_total_food(const World* world) {
+    if (world == NULL) return 0;
+    
+    // Unallocated tiles cannot hold food
+    int total_food = 0;
+    size_t tile_count = (size_t)world->tiles_x * (size_t)world->tiles_y;
+    for (size_t t = 0; t < tile_count; t++) {
+        const WorldTile* tile = world->tiles[t];
+        if (tile == NULL) continue;
+        
+        for (int i = 0; i < WORLD_TILE_CELLS; i++) {
+            if (tile->terrain[i] == TERRAIN_FOOD) {
+                total_food += tile->food_amount[i];
+            }
+        }
+    }
+    return total_food;
 }
 
 // World initialization
@@ -229,18 +462,28 @@ void initialize_world_random(World* world) {
     
     print_info("Initializing world with random obstacles...");
     
-    // Add some random obstacles
-    int obstacle_count = (world->width * world->height) / 20; // 5% of cells
+    // Add some random obstacles. Each cluster is a short random walk, so it
+    // stays within a tile or two; scattering single cells over a large
+    // world would allocate nearly every tile.
+    int64_t cell_count = (int64_t)world->width * world->height;
+    int obstacle_count = (int)((cell_count / RANDOM_OBSTACLE_DENSITY < RANDOM_OBSTACLE_LIMIT) ?
+                               cell_count / RANDOM_OBSTACLE_DENSITY : RANDOM_OBSTACLE_LIMIT);
     
-    for (int i = 0; i < obstacle_count; i++) {
+    for (int i = 0; i < obstacle_count; i += RANDOM_OBSTACLE_CLUSTER) {
         int x = random_int(0, world->width - 1);
         int y = random_int(0, world->height - 1);
         
-        // Don't place obstacles on edges or where colonies will be
-        if (x > 0 && x < world->width - 1 && y > 0 && y < world->height - 1) {
-            if (world->grid[y][x].terrain == TERRAIN_EMPTY) {
-                place_obstacle(world, x, y);
+        for (int j = 0; j < RANDOM_OBSTACLE_CLUSTER && i + j < obstacle_count; j++) {
+            // Don't place obstacles on edges or where colonies will be
+            if (x > 0 && x < world->width - 1 && y > 0 && y < world->height - 1) {
+                if (get_terrain(world, x, y) == TERRAIN_EMPTY) {
+                    place_obstacle(world, x, y);
+                }
             }
+            
+            int direction = random_int(0, 7);
+            x = clamp_int(x + dx[direction], 0, world->width - 1);
+            y = clamp_int(y + dy[direction], 0, world->height - 1);
         }
     }
     
@@ -251,7 +494,7 @@ void initialize_world_random(World* world) {
         int x = random_int(0, world->width - 1);
         int y = random_int(0, world->height - 1);
         
-        if (world->grid[y][x].terrain == TERRAIN_EMPTY) {
+        if (get_terrain(world, x, y) == TERRAIN_EMPTY) {
             int amount = random_int(20, 100);
             place_food(world, x, y, amount);
         }
@@ -311,17 +554,7 @@ void spawn_initial_ants(World* world) {
     print_info("Spawning initial ants...");
     
     for (int i = 0; i < world->colony_count; i++) {
-        Colony* colony = &world->colonies[i];
-        
-        // Spawn initial ants at nest position
-        for (int j = 0; j < INITIAL_ANTS_PER_COLONY; j++) {
-            // This will be implemented in ant_logic.c
-            // For now, just increment the count
-            colony->total_ants++;
-            colony->active_ants++;
-        }
-        
-        print_info("Colony %d: %d ants spawned", i, INITIAL_ANTS_PER_COLONY);
+        spawn_ants(world, i, world->initial_ants);
     }
 }
 
@@ -333,12 +566,10 @@ void update_colony_statistics(World* world) {
         
         // Count active ants
         int active_count = 0;
-        Ant* current = colony->ants_head;
-        while (current != NULL) {
-            if (!(current->state & ANT_STATE_DEAD)) {
+        for (int index = 0; index < colony->ants.count; index++) {
+            if (!(colony->ants.state[index] & ANT_STATE_DEAD)) {
                 active_count++;
             }
-            current = current->next;
         }
         
         colony->active_ants = active_count;
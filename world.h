@@ -3,6 +3,32 @@
 
 #include "data_structures.h"
 
+// Index of the tile holding (x, y) and of the cell inside that tile
+#define WORLD_TILE_INDEX(world, x, y) \
+    ((size_t)((y) >> WORLD_TILE_SHIFT) * (size_t)(world)->tiles_x + (size_t)((x) >> WORLD_TILE_SHIFT))
+#define TILE_CELL_INDEX(x, y) ((((y) & WORLD_TILE_MASK) << WORLD_TILE_SHIFT) | ((x) & WORLD_TILE_MASK))
+
+// Pheromone channel of one colony's trail type; channels are colony-major
+#define PHEROMONE_CHANNEL(colony_id, type) ((colony_id) * PHEROMONE_TYPE_COUNT + (type))
+
+// Current (front) and scratch (back) pheromone planes of a tile. Planes of
+// consecutive channels are contiguous, so TILE_PHEROMONE(tile, 0) spans all
+// channels of the buffer.
+#define TILE_PHEROMONE(tile, channel) \
+    ((tile)->pheromone[(tile)->front] + (size_t)(channel) * WORLD_TILE_CELLS)
+#define TILE_PHEROMONE_BACK(tile, channel) \
+    ((tile)->pheromone[(tile)->front ^ 1] + (size_t)(channel) * WORLD_TILE_CELLS)
+
+// Direction plane of one channel of a tile
+#define TILE_GRADIENT(tile, channel) ((tile)->gradient + (size_t)(channel) * WORLD_TILE_CELLS)
+
+// Terrain ants can stand on
+#define TERRAIN_WALKABLE(terrain) \
+    ((terrain) == TERRAIN_EMPTY || (terrain) == TERRAIN_FOOD || (terrain) == TERRAIN_NEST)
+
+// Active-tile bitmap words for one tile row
+#define TILE_ACTIVE_ROW(world, tile_y) ((world)->active_tiles + (size_t)(tile_y) * (world)->active_row_words)
+
 // World creation and destruction
 World* create_world(int width, int height, int colony_count);
 void destroy_world(World* world);
@@ -16,7 +42,28 @@ void clear_cell(World* world, int x, int y);
 // World queries
 int is_valid_position(const World* world, int x, int y);
 int is_walkable(const World* world, int x, int y);
-Cell* get_cell(const World* world, int x, int y);
+int get_cell(const World* world, int x, int y, Cell* cell);
+uint8_t get_walk_mask(const World* world, int x, int y);  // Bit d: neighbour in direction d is walkable
+
+// Tile access (get_tile returns NULL for untouched regions)
+WorldTile* get_tile(const World* world, int x, int y);
+WorldTile* get_or_create_tile(World* world, int x, int y);
+
+// Active pheromone tiles (indexed by tile coordinates)
+int is_tile_active(const World* world, int tile_x, int tile_y);
+void set_tile_active(World* world, int tile_x, int tile_y, int active);
+int next_active_tile(const World* world, int tile_y, int tile_x);  // -1 when none is left
+int count_active_tiles(const World* world);
+void invalidate_gradient_cells(World* world, int x, int y, int channel);  // channel -1 = all
+
+// Cell field accessors
+TerrainType get_terrain(const World* world, int x, int y);
+void set_terrain(World* world, int x, int y, TerrainType terrain);
+int get_food_amount(const World* world, int x, int y);
+void set_food_amount(World* world, int x, int y, int amount);
+int get_nest_colony(const World* world, int x, int y);
+void set_nest_colony(World* world, int x, int y, int colony_id);
+int count_total_food(const World* world);
 
 // World initialization
 void initialize_world_random(World* world);